@@ -0,0 +1,50 @@
+#pragma once
+
+#include <malloc.h>
+#include <new>
+#include <vector>
+
+// ============================================================================
+// ALIGNED ALLOCATOR
+// ============================================================================
+
+// _aligned_malloc and _aligned_free for everything in the game. Debug builds count
+// these allocations along with operator new, see GetHeapAllocationCount.
+void* AlignedMalloc(size_t size, size_t alignment);
+void AlignedFree(void* memory);
+
+// std::vector allocator returning Alignment-aligned storage, so arrays start on
+// a cache line and SIMD loads of their first elements never split one.
+template <typename T, size_t Alignment>
+struct AlignedAllocator {
+    using value_type = T;
+
+    template <typename U>
+    struct rebind {
+        using other = AlignedAllocator<U, Alignment>;
+    };
+
+    AlignedAllocator() = default;
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment>&) {}
+
+    T* allocate(size_t count) {
+        void* memory = AlignedMalloc(count * sizeof(T), Alignment);
+        if (!memory) throw std::bad_alloc();
+        return static_cast<T*>(memory);
+    }
+
+    void deallocate(T* memory, size_t) {
+        AlignedFree(memory);
+    }
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U, Alignment>&) const { return true; }
+    template <typename U>
+    bool operator!=(const AlignedAllocator<U, Alignment>&) const { return false; }
+};
+
+constexpr size_t CACHE_LINE_SIZE = 64;
+
+template <typename T>
+using AlignedVector = std::vector<T, AlignedAllocator<T, CACHE_LINE_SIZE>>;
@@ -0,0 +1,76 @@
+#include "BVHNodePool.h"
+
+#include <cstring>
+
+// ============================================================================
+// BVH NODE POOL IMPLEMENTATION
+// ============================================================================
+
+int BVHNodePool::Allocate(const BVHNode& node) {
+    int index;
+    if (m_freeHead >= 0) {
+        index = m_freeHead;
+        m_freeHead = (*this)[index].leftChild;
+        m_freeCount--;
+    } else {
+        index = m_size++;
+        if ((index >> CHUNK_SHIFT) >= static_cast<int>(m_chunks.size())) {
+            m_chunks.emplace_back(static_cast<size_t>(CHUNK_SIZE));
+        }
+    }
+    (*this)[index] = node;
+    return index;
+}
+
+void BVHNodePool::Free(int index) {
+    BVHNode& node = (*this)[index];
+    node = BVHNode();
+    node.leftChild = m_freeHead;
+    node.rightChild = FREE_NODE;
+    m_freeHead = index;
+    m_freeCount++;
+}
+
+void BVHNodePool::Clear() {
+    m_size = 0;
+    m_freeHead = -1;
+    m_freeCount = 0;
+}
+
+void BVHNodePool::Reserve(size_t count) {
+    while (m_chunks.size() * CHUNK_SIZE < count) {
+        m_chunks.emplace_back(static_cast<size_t>(CHUNK_SIZE));
+    }
+}
+
+void BVHNodePool::Swap(BVHNodePool& other) {
+    m_chunks.swap(other.m_chunks);
+    std::swap(m_size, other.m_size);
+    std::swap(m_freeHead, other.m_freeHead);
+    std::swap(m_freeCount, other.m_freeCount);
+}
+
+void BVHNodePool::CopyTo(BVHNode* outNodes) const {
+    for (int first = 0; first < m_size; first += CHUNK_SIZE) {
+        int count = std::min(static_cast<int>(CHUNK_SIZE), m_size - first);
+        memcpy(outNodes + first, m_chunks[first >> CHUNK_SHIFT].data(), sizeof(BVHNode) * count);
+    }
+}
+
+void BVHNodePool::CopyFrom(const BVHNode* nodes, int count) {
+    Clear();
+    Reserve(count);
+    m_size = count;
+    for (int first = 0; first < count; first += CHUNK_SIZE) {
+        int chunkCount = std::min(static_cast<int>(CHUNK_SIZE), count - first);
+        memcpy(m_chunks[first >> CHUNK_SHIFT].data(), nodes + first, sizeof(BVHNode) * chunkCount);
+    }
+    
+    for (int i = 0; i < count; i++) {
+        if (IsFree(i)) {
+            (*this)[i].leftChild = m_freeHead;
+            m_freeHead = i;
+            m_freeCount++;
+        }
+    }
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "Common.h"
+#include "Structures.h"
+#include "AlignedAllocator.h"
+
+// ============================================================================
+// BVH NODE POOL
+// ============================================================================
+
+// Node storage in fixed-size chunks. Growing appends a chunk and never moves a
+// node, so indices and references stay valid while the tree is edited. Freed
+// nodes are linked into an intrusive free list through their leftChild and
+// handed out again first, making allocate and free O(1).
+class BVHNodePool {
+public:
+    BVHNodePool() = default;
+
+    int Allocate(const BVHNode& node);
+    void Free(int index);
+    // Forgets every node but keeps the chunks
+    void Clear();
+    void Reserve(size_t count);
+    void Swap(BVHNodePool& other);
+
+    BVHNode& operator[](int index) { return m_chunks[index >> CHUNK_SHIFT][index & CHUNK_MASK]; }
+    const BVHNode& operator[](int index) const { return m_chunks[index >> CHUNK_SHIFT][index & CHUNK_MASK]; }
+
+    // Indices below Size() have been handed out; FreeCount() of them are on the free list
+    int Size() const { return m_size; }
+    bool Empty() const { return m_size == 0; }
+    int FreeCount() const { return m_freeCount; }
+    bool IsFree(int index) const { return (*this)[index].rightChild == FREE_NODE; }
+    
+    // A flat array indexed like the pool, e.g. the GPU node buffer. Nodes are stored
+    // in the shaders' layout, so each chunk is one memcpy. CopyFrom replaces the
+    // contents and relinks nodes that were on a free list when copied out.
+    void CopyTo(BVHNode* outNodes) const;
+    void CopyFrom(const BVHNode* nodes, int count);
+
+private:
+    static constexpr int CHUNK_SHIFT = Config::BVH_NODE_CHUNK_SHIFT;
+    static constexpr int CHUNK_SIZE = 1 << CHUNK_SHIFT;
+    static constexpr int CHUNK_MASK = CHUNK_SIZE - 1;
+    static constexpr int FREE_NODE = -2;    // rightChild of a node on the free list
+
+    std::vector<AlignedVector<BVHNode>> m_chunks;
+    int m_size = 0;
+    int m_freeHead = -1;
+    int m_freeCount = 0;
+};
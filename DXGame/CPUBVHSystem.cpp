@@ -1,51 +1,360 @@
 #include "CPUBVHSystem.h"
 
-void CPUBVHSystem::BuildBVH(const std::vector<RenderObject>& objects) {
-    if (objects.empty()) return;
+namespace {
+    float SurfaceArea(const Vector3& minBounds, const Vector3& maxBounds) {
+        Vector3 extent = maxBounds - minBounds;
+        return 2.0f * (extent.x * extent.y + extent.y * extent.z + extent.z * extent.x);
+    }
+}
+
+void CPUBVHSystem::BuildBVH(const ObjectStore& objects) {
+    if (objects.Empty()) return;
     
-    m_bvhNodes.clear();
-    m_bvhNodes.reserve(objects.size() * 2);
+    ArenaVector<int> objectIndices(objects.Size(), 0, ArenaAllocator<int>(m_frameArena));
+    for (size_t i = 0; i < objects.Size(); ++i) {
+        objectIndices[i] = static_cast<int>(i);
+    }
+    BuildFromIndices(objects, objectIndices.data(), objectIndices.size());
+}
+
+void CPUBVHSystem::BuildBVH(const ObjectStore& objects, const std::vector<int>& objectIndices) {
+    BuildFromIndices(objects, objectIndices.data(), objectIndices.size());
+}
+
+void CPUBVHSystem::BuildFromIndices(const ObjectStore& objects, const int* objectIndices, size_t count) {
+    m_bvhNodes.Clear();
+    m_rootNode = -1;
+    m_parents.clear();
+    m_objectLeaf.assign(objects.Size(), -1);
+    m_incrementalNodeChanges = 0;
+    m_candidateNodesStale = true;
+    if (count == 0) return;
+    
+    m_bvhNodes.Reserve(count * 2);
     
     // Create leaf nodes
-    std::vector<int> objectIndices;
-    for (size_t i = 0; i < objects.size(); ++i) {
-        BVHNode leafNode;
-        leafNode.minBounds = objects[i].minBounds;
-        leafNode.maxBounds = objects[i].maxBounds;
-        leafNode.objectIndex = static_cast<int>(i);
-        leafNode.isLeaf = true;
-        
-        m_bvhNodes.push_back(leafNode);
-        objectIndices.push_back(static_cast<int>(m_bvhNodes.size() - 1));
+    ArenaAllocator<int> arenaAllocator(m_frameArena);
+    ArenaVector<int> leafIndices(arenaAllocator);
+    leafIndices.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        int objectIndex = objectIndices[i];
+        leafIndices.push_back(m_bvhNodes.Allocate(MakeLeaf(objects, objectIndex)));
+        m_objectLeaf[objectIndex] = leafIndices.back();
     }
     
     // Build tree recursively
-    m_rootNode = BuildBVHRecursive(objectIndices);
+    m_rootNode = BuildBVHRecursive(leafIndices.data(), leafIndices.data() + leafIndices.size());
+    
+    m_parents.assign(m_bvhNodes.Size(), -1);
+    for (int i = 0; i < m_bvhNodes.Size(); ++i) {
+        if (!m_bvhNodes[i].isLeaf) {
+            m_parents[m_bvhNodes[i].leftChild] = i;
+            m_parents[m_bvhNodes[i].rightChild] = i;
+        }
+    }
 }
 
-void CPUBVHSystem::PerformFrustumCulling(const Frustum& frustum, std::vector<RenderObject>& objects) {
-    // Reset all objects to not visible
-    for (auto& obj : objects) {
-        obj.visible = false;
+void CPUBVHSystem::InsertObject(const ObjectStore& objects, int objectIndex) {
+    if (objectIndex < 0 || objectIndex >= static_cast<int>(objects.Size())) return;
+    if (m_objectLeaf.size() < objects.Size()) {
+        m_objectLeaf.resize(objects.Size(), -1);
+    }
+    if (m_objectLeaf[objectIndex] >= 0) return;
+    
+    m_candidateNodesStale = true;
+    int leaf = AllocateNode(MakeLeaf(objects, objectIndex));
+    m_objectLeaf[objectIndex] = leaf;
+    if (m_rootNode < 0) {
+        m_rootNode = leaf;
+        return;
+    }
+    
+    // Descend while a child's enlargement (plus what every ancestor already pays
+    // to grow) is cheaper than pairing the leaf with the current node
+    Vector3 leafMin = m_bvhNodes[leaf].minBounds;
+    Vector3 leafMax = m_bvhNodes[leaf].maxBounds;
+    int sibling = m_rootNode;
+    while (!m_bvhNodes[sibling].isLeaf) {
+        const BVHNode& node = m_bvhNodes[sibling];
+        float area = SurfaceArea(node.minBounds, node.maxBounds);
+        float combinedArea = SurfaceArea(Vector3::Min(node.minBounds, leafMin), Vector3::Max(node.maxBounds, leafMax));
+        float pairCost = 2.0f * combinedArea;
+        float inheritedCost = 2.0f * (combinedArea - area);
+        
+        float childCost[2];
+        int children[2] = { node.leftChild, node.rightChild };
+        for (int c = 0; c < 2; c++) {
+            const BVHNode& child = m_bvhNodes[children[c]];
+            float enlarged = SurfaceArea(Vector3::Min(child.minBounds, leafMin), Vector3::Max(child.maxBounds, leafMax));
+            childCost[c] = (child.isLeaf ? enlarged : enlarged - SurfaceArea(child.minBounds, child.maxBounds)) + inheritedCost;
+        }
+        
+        if (pairCost <= childCost[0] && pairCost <= childCost[1]) break;
+        sibling = childCost[0] <= childCost[1] ? children[0] : children[1];
     }
     
+    // New parent takes the sibling's place
+    int oldParent = m_parents[sibling];
+    BVHNode parentNode;
+    parentNode.leftChild = sibling;
+    parentNode.rightChild = leaf;
+    int newParent = AllocateNode(parentNode);
+    m_parents[newParent] = oldParent;
+    m_parents[sibling] = newParent;
+    m_parents[leaf] = newParent;
+    
+    if (oldParent < 0) {
+        m_rootNode = newParent;
+    } else if (m_bvhNodes[oldParent].leftChild == sibling) {
+        m_bvhNodes[oldParent].leftChild = newParent;
+    } else {
+        m_bvhNodes[oldParent].rightChild = newParent;
+    }
+    RefitAncestors(newParent);
+}
+
+void CPUBVHSystem::RemoveObject(const ObjectRemoval& removal) {
+    int objectCount = static_cast<int>(m_objectLeaf.size());
+    if (removal.index < 0 || removal.index >= objectCount) return;
+    
+    int leaf = m_objectLeaf[removal.index];
+    m_objectLeaf[removal.index] = -1;
+    if (leaf >= 0) {
+        m_candidateNodesStale = true;
+        int parent = m_parents[leaf];
+        FreeNode(leaf);
+        
+        if (parent < 0) {
+            m_rootNode = -1;
+        } else {
+            // The sibling takes the parent's place
+            int sibling = m_bvhNodes[parent].leftChild == leaf ? m_bvhNodes[parent].rightChild : m_bvhNodes[parent].leftChild;
+            int grandparent = m_parents[parent];
+            m_parents[sibling] = grandparent;
+            FreeNode(parent);
+            
+            if (grandparent < 0) {
+                m_rootNode = sibling;
+            } else {
+                if (m_bvhNodes[grandparent].leftChild == parent) {
+                    m_bvhNodes[grandparent].leftChild = sibling;
+                } else {
+                    m_bvhNodes[grandparent].rightChild = sibling;
+                }
+                RefitAncestors(grandparent);
+            }
+        }
+    }
+    
+    // The last object moved into the freed index
+    if (removal.movedFrom != removal.index && removal.movedFrom < objectCount) {
+        int movedLeaf = m_objectLeaf[removal.movedFrom];
+        if (movedLeaf >= 0) {
+            m_bvhNodes[movedLeaf].objectIndex = removal.index;
+            m_candidateNodesStale = true;
+        }
+        m_objectLeaf[removal.index] = movedLeaf;
+    }
+    if (removal.movedFrom < objectCount) {
+        m_objectLeaf.resize(removal.movedFrom);
+    }
+}
+
+void CPUBVHSystem::PerformFrustumCulling(const Frustum& frustum, ObjectStore& objects) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+    m_stats.Reset();
+    
+    // Reset all objects to not visible
+    objects.visible.ResetAll();
+    
     // Traverse BVH and perform frustum culling
     if (IsValid()) {
+        UpdateCandidateNodes(objects.Size());
         FrustumCullBVH(m_rootNode, frustum, objects);
     }
+    
+    m_stats.cullTimeMs = std::chrono::duration<float, std::milli>(
+        std::chrono::high_resolution_clock::now() - startTime).count();
+}
+
+void CPUBVHSystem::AccumulateFrustumCulling(const Frustum& frustum, ObjectStore& objects) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+    m_stats.Reset();
+    
+    if (IsValid()) {
+        UpdateCandidateNodes(objects.Size());
+        FrustumCullBVH(m_rootNode, frustum, objects);
+    }
+    
+    m_stats.cullTimeMs = std::chrono::duration<float, std::milli>(
+        std::chrono::high_resolution_clock::now() - startTime).count();
+}
+
+void CPUBVHSystem::PerformMultiViewCulling(const std::vector<Frustum>& frustums, const ObjectStore& objects,
+                                           std::vector<uint32_t>& viewMasks) {
+    viewMasks.assign(objects.Size(), 0u);
+    
+    int viewCount = static_cast<int>(frustums.size());
+    if (viewCount > Config::MAX_CULL_VIEWS) {
+        OutputDebugStringA("CPU BVH: Too many views for batched culling, extra views ignored\n");
+        viewCount = Config::MAX_CULL_VIEWS;
+    }
+    if (viewCount == 0 || !IsValid()) return;
+    
+    // Transpose every view's planes once so each node test is pure SIMD
+    m_packedViews.resize(viewCount);
+    for (int v = 0; v < viewCount; v++) {
+        m_packedViews[v].Pack(frustums[v]);
+    }
+    
+    uint32_t allViews = (viewCount == 32) ? 0xFFFFFFFFu : ((1u << viewCount) - 1u);
+    MultiViewCullBVH(m_rootNode, allViews, viewMasks);
+}
+
+BVHNode CPUBVHSystem::MakeLeaf(const ObjectStore& objects, int objectIndex) const {
+    const ObjectBounds& bounds = objects.bounds[objectIndex];
+    const ObjectSphere& sphere = objects.spheres[objectIndex];
+    BVHNode leafNode;
+    leafNode.minBounds = bounds.minBounds;
+    leafNode.maxBounds = bounds.maxBounds;
+    leafNode.objectIndex = objectIndex;
+    leafNode.isLeaf = true;
+    
+    // Prefer the object's own sphere, it is usually tighter than the box's
+    if (sphere.radius >= 0.0f) {
+        leafNode.sphereCenter = sphere.center;
+        leafNode.sphereRadius = sphere.radius;
+    } else {
+        leafNode.ComputeSphereFromBounds();
+    }
+    return leafNode;
+}
+
+int CPUBVHSystem::AllocateNode(const BVHNode& node) {
+    int nodeIndex = m_bvhNodes.Allocate(node);
+    if (nodeIndex >= static_cast<int>(m_parents.size())) {
+        m_parents.resize(nodeIndex + 1, -1);
+    }
+    m_parents[nodeIndex] = -1;
+    m_incrementalNodeChanges++;
+    return nodeIndex;
+}
+
+void CPUBVHSystem::FreeNode(int nodeIndex) {
+    // Unreachable from the root; reused by the next insert
+    m_bvhNodes.Free(nodeIndex);
+    m_parents[nodeIndex] = -1;
+    m_incrementalNodeChanges++;
+}
+
+void CPUBVHSystem::RemapObjects(const ObjectReorder& reorder) {
+    std::vector<int> objectLeaf(reorder.newIndex.size(), -1);
+    for (size_t i = 0; i < m_objectLeaf.size() && i < reorder.newIndex.size(); i++) {
+        int leaf = m_objectLeaf[i];
+        if (leaf < 0) continue;
+        int newIndex = reorder.newIndex[i];
+        m_bvhNodes[leaf].objectIndex = newIndex;
+        objectLeaf[newIndex] = leaf;
+    }
+    m_objectLeaf.swap(objectLeaf);
+    m_candidateNodesStale = true;
+}
+
+void CPUBVHSystem::GetLeafOrder(std::vector<uint32_t>& outOrder) const {
+    outOrder.clear();
+    if (!IsValid()) return;
+
+    // Left child first, as traversal visits it
+    std::vector<int> stack;
+    stack.push_back(m_rootNode);
+    while (!stack.empty()) {
+        const BVHNode& node = m_bvhNodes[stack.back()];
+        stack.pop_back();
+        if (node.isLeaf) {
+            if (node.objectIndex >= 0) {
+                outOrder.push_back(static_cast<uint32_t>(node.objectIndex));
+            }
+        } else {
+            stack.push_back(node.rightChild);
+            stack.push_back(node.leftChild);
+        }
+    }
+}
+
+void CPUBVHSystem::Compact() {
+    m_incrementalNodeChanges = 0;
+    if (!IsValid()) return;
+    
+    m_compactNodes.Clear();
+    m_compactNodes.Reserve(m_bvhNodes.Size() - m_bvhNodes.FreeCount());
+    m_parents.assign(m_bvhNodes.Size() - m_bvhNodes.FreeCount(), -1);
+    m_rootNode = CopyDepthFirst(m_rootNode, -1);
+    m_bvhNodes.Swap(m_compactNodes);
+    m_candidateNodesStale = true;
+}
+
+void CPUBVHSystem::AdoptTree(BVHNodePool& nodes, int rootNode, const ObjectStore& objects) {
+    m_bvhNodes.Swap(nodes);
+    m_rootNode = m_bvhNodes.Empty() ? -1 : rootNode;
+    m_incrementalNodeChanges = 0;
+    m_candidateNodesStale = true;
+    
+    m_parents.assign(m_bvhNodes.Size(), -1);
+    m_objectLeaf.assign(objects.Size(), -1);
+    for (int i = 0; i < m_bvhNodes.Size(); ++i) {
+        const BVHNode& node = m_bvhNodes[i];
+        if (m_bvhNodes.IsFree(i)) continue;
+        if (node.isLeaf) {
+            if (node.objectIndex >= 0 && node.objectIndex < static_cast<int>(objects.Size())) {
+                m_objectLeaf[node.objectIndex] = i;
+            }
+        } else {
+            m_parents[node.leftChild] = i;
+            m_parents[node.rightChild] = i;
+        }
+    }
 }
 
-int CPUBVHSystem::BuildBVHRecursive(std::vector<int>& nodeIndices) {
-    if (nodeIndices.size() == 1) {
-        return nodeIndices[0];
+int CPUBVHSystem::CopyDepthFirst(int nodeIndex, int parent) {
+    const BVHNode& node = m_bvhNodes[nodeIndex];
+    int newIndex = m_compactNodes.Allocate(node);
+    m_parents[newIndex] = parent;
+    
+    if (node.isLeaf) {
+        if (node.objectIndex >= 0 && node.objectIndex < static_cast<int>(m_objectLeaf.size())) {
+            m_objectLeaf[node.objectIndex] = newIndex;
+        }
+    } else {
+        int left = CopyDepthFirst(node.leftChild, newIndex);
+        int right = CopyDepthFirst(node.rightChild, newIndex);
+        m_compactNodes[newIndex].leftChild = left;
+        m_compactNodes[newIndex].rightChild = right;
+    }
+    return newIndex;
+}
+
+void CPUBVHSystem::RefitAncestors(int nodeIndex) {
+    for (int i = nodeIndex; i >= 0; i = m_parents[i]) {
+        BVHNode& node = m_bvhNodes[i];
+        const BVHNode& left = m_bvhNodes[node.leftChild];
+        const BVHNode& right = m_bvhNodes[node.rightChild];
+        node.minBounds = Vector3::Min(left.minBounds, right.minBounds);
+        node.maxBounds = Vector3::Max(left.maxBounds, right.maxBounds);
+        node.ComputeSphereFromBounds();
+    }
+}
+
+int CPUBVHSystem::BuildBVHRecursive(int* first, int* last) {
+    if (last - first == 1) {
+        return *first;
     }
     
     // Calculate bounding box for all nodes
-    Vector3 minBounds = m_bvhNodes[nodeIndices[0]].minBounds;
-    Vector3 maxBounds = m_bvhNodes[nodeIndices[0]].maxBounds;
+    Vector3 minBounds = m_bvhNodes[*first].minBounds;
+    Vector3 maxBounds = m_bvhNodes[*first].maxBounds;
     
-    for (size_t i = 1; i < nodeIndices.size(); ++i) {
-        const auto& node = m_bvhNodes[nodeIndices[i]];
+    for (const int* it = first + 1; it != last; ++it) {
+        const auto& node = m_bvhNodes[*it];
         minBounds = Vector3::Min(minBounds, node.minBounds);
         maxBounds = Vector3::Max(maxBounds, node.maxBounds);
     }
@@ -57,7 +366,7 @@ int CPUBVHSystem::BuildBVHRecursive(std::vector<int>& nodeIndices) {
     if (extent.z > (axis == 0 ? extent.x : extent.y)) axis = 2;
     
     // Sort nodes along the chosen axis
-    std::sort(nodeIndices.begin(), nodeIndices.end(), [this, axis](int a, int b) {
+    std::sort(first, last, [this, axis](int a, int b) {
         Vector3 centerA = (m_bvhNodes[a].minBounds + m_bvhNodes[a].maxBounds) * 0.5f;
         Vector3 centerB = (m_bvhNodes[b].minBounds + m_bvhNodes[b].maxBounds) * 0.5f;
         if (axis == 0)
@@ -68,41 +377,86 @@ int CPUBVHSystem::BuildBVHRecursive(std::vector<int>& nodeIndices) {
             return centerA.z < centerB.z;
     });
     
-    // Split in half
-    size_t mid = nodeIndices.size() / 2;
-    std::vector<int> leftNodes(nodeIndices.begin(), nodeIndices.begin() + mid);
-    std::vector<int> rightNodes(nodeIndices.begin() + mid, nodeIndices.end());
+    // Split in half; each half is already contiguous, so the children sort their own ranges
+    int* mid = first + (last - first) / 2;
     
     // Create internal node
     BVHNode internalNode;
     internalNode.minBounds = minBounds;
     internalNode.maxBounds = maxBounds;
     internalNode.isLeaf = false;
+    internalNode.ComputeSphereFromBounds();
     
-    m_bvhNodes.push_back(internalNode);
-    int nodeIndex = static_cast<int>(m_bvhNodes.size() - 1);
+    int nodeIndex = m_bvhNodes.Allocate(internalNode);
     
     // Recursively build children
-    m_bvhNodes[nodeIndex].leftChild = BuildBVHRecursive(leftNodes);
-    m_bvhNodes[nodeIndex].rightChild = BuildBVHRecursive(rightNodes);
+    m_bvhNodes[nodeIndex].leftChild = BuildBVHRecursive(first, mid);
+    m_bvhNodes[nodeIndex].rightChild = BuildBVHRecursive(mid, last);
     
     return nodeIndex;
 }
 
-void CPUBVHSystem::FrustumCullBVH(int nodeIndex, const Frustum& frustum, std::vector<RenderObject>& objects) {
-    if (nodeIndex < 0 || nodeIndex >= static_cast<int>(m_bvhNodes.size())) return;
+void CPUBVHSystem::FrustumCullBVH(int nodeIndex, const Frustum& frustum, ObjectStore& objects) {
+    if (nodeIndex < 0 || nodeIndex >= m_bvhNodes.Size()) return;
     
     const auto& node = m_bvhNodes[nodeIndex];
+    m_stats.nodesVisited++;
     
-    // Check if node is in frustum
-    if (!frustum.IsBoxInFrustum(node.minBounds, node.maxBounds)) {
+    // Nothing below can be visible from this cell
+    if (IsRejectedByCandidateMask(nodeIndex)) {
+        return;
+    }
+    
+    // Sub-pixel nodes are dropped before any plane math
+    if (IsRejectedAsTooSmall(node)) {
+        return;
+    }
+    
+    if (m_useBoundingSpheres && node.sphereRadius >= 0.0f) {
+        // Sphere decides most nodes with one dot product per plane
+        uint32_t straddling = 0;
+        CullResult result = frustum.TestSphere(node.sphereCenter, node.sphereRadius, &straddling);
+        
+        if (result == CullResult::Outside) {
+            m_stats.sphereRejects++;
+            m_stats.nodesCulled++;
+            return;
+        }
+        
+        if (result == CullResult::Inside) {
+            // Sphere encloses the box, so the whole subtree is inside - no further tests
+            m_stats.sphereAccepts++;
+            MarkSubtreeVisible(nodeIndex, objects);
+            return;
+        }
+        
+        // Sphere straddles some planes - only those need the tighter AABB test
+        m_stats.aabbFallbacks++;
+        if (!frustum.IsBoxInFrustum(node.minBounds, node.maxBounds, straddling)) {
+            m_stats.nodesCulled++;
+            return;
+        }
+    } else if (!frustum.IsBoxInFrustum(node.minBounds, node.maxBounds)) {
+        m_stats.nodesCulled++;
         return; // Node is outside frustum, skip entire subtree
     }
     
+    // Plane test passed - large nodes near frustum corners may still be outside
+    if (IsRejectedByExactTest(node, frustum)) {
+        m_stats.nodesCulled++;
+        return;
+    }
+    
+    // In view - hidden behind the occluders?
+    if (IsRejectedByOcclusion(node)) {
+        return;
+    }
+    
     if (node.isLeaf) {
         // Mark object as visible
-        if (node.objectIndex >= 0 && node.objectIndex < static_cast<int>(objects.size())) {
-            objects[node.objectIndex].visible = true;
+        if (node.objectIndex >= 0 && node.objectIndex < static_cast<int>(objects.Size()) &&
+            !IsRejectedByOrientedBox(node.objectIndex, frustum, objects)) {
+            objects.visible.Set(node.objectIndex);
         }
     } else {
         // Recursively check children
@@ -110,3 +464,140 @@ void CPUBVHSystem::FrustumCullBVH(int nodeIndex, const Frustum& frustum, std::ve
         FrustumCullBVH(node.rightChild, frustum, objects);
     }
 }
+
+bool CPUBVHSystem::IsRejectedByExactTest(const BVHNode& node, const Frustum& frustum) {
+    if (!m_useExactTest) return false;
+    
+    // Small nodes rarely produce corner false positives, so they skip the extra axes
+    float nodeRadius = ((node.maxBounds - node.minBounds) * 0.5f).Length();
+    if (nodeRadius < m_exactTestSizeRatio * frustum.boundingRadius) return false;
+    
+    m_stats.satTests++;
+    if (frustum.HasSeparatingAxis(node.minBounds, node.maxBounds)) {
+        m_stats.satRejects++;
+        return true;
+    }
+    return false;
+}
+
+bool CPUBVHSystem::IsRejectedAsTooSmall(const BVHNode& node) {
+    if (!m_screenSize.IsEnabled() || !m_screenSize.IsTooSmall(node.minBounds, node.maxBounds)) {
+        return false;
+    }
+    m_stats.smallRejects++;
+    return true;
+}
+
+bool CPUBVHSystem::IsRejectedByOcclusion(const BVHNode& node) {
+    if (!m_occlusionPyramid || !m_occlusionPyramid->IsValid()) return false;
+    
+    m_stats.hizTests++;
+    if (m_occlusionPyramid->IsOccluded(node.minBounds, node.maxBounds)) {
+        m_stats.hizRejects++;
+        return true;
+    }
+    return false;
+}
+
+bool CPUBVHSystem::IsRejectedByOrientedBox(int objectIndex, const Frustum& frustum, const ObjectStore& objects) {
+    if (!objects.HasOrientedBox(objectIndex)) return false;
+    
+    m_stats.orientedTests++;
+    const ObjectOrientedBox& box = objects.orientedBoxes[objectIndex];
+    if (!frustum.IsOrientedBoxInFrustum(box.center, box.axes)) {
+        m_stats.orientedRejects++;
+        m_stats.nodesCulled++;
+        return true;
+    }
+    return false;
+}
+
+bool CPUBVHSystem::IsRejectedByCandidateMask(int nodeIndex) {
+    if (m_nodeHasCandidate.empty() || m_nodeHasCandidate[nodeIndex]) return false;
+    
+    m_stats.candidateRejects++;
+    return true;
+}
+
+void CPUBVHSystem::UpdateCandidateNodes(size_t objectCount) {
+    if (!m_candidateNodesStale) return;
+    m_candidateNodesStale = false;
+    
+    if (!m_candidateMask || m_candidateMask->Size() != objectCount) {
+        m_nodeHasCandidate.clear();
+        return;
+    }
+    
+    // Incremental inserts break build order, so children are settled before parents by walking the tree
+    m_nodeHasCandidate.assign(m_bvhNodes.Size(), 0);
+    if (m_rootNode >= 0) {
+        MarkCandidateNodes(m_rootNode, objectCount);
+    }
+}
+
+uint8_t CPUBVHSystem::MarkCandidateNodes(int nodeIndex, size_t objectCount) {
+    const auto& node = m_bvhNodes[nodeIndex];
+    uint8_t hasCandidate;
+    if (node.isLeaf) {
+        int objectIndex = node.objectIndex;
+        hasCandidate = (objectIndex >= 0 && objectIndex < static_cast<int>(objectCount)) ?
+            m_candidateMask->Test(objectIndex) : 1;
+    } else {
+        hasCandidate = MarkCandidateNodes(node.leftChild, objectCount) | MarkCandidateNodes(node.rightChild, objectCount);
+    }
+    m_nodeHasCandidate[nodeIndex] = hasCandidate;
+    return hasCandidate;
+}
+
+void CPUBVHSystem::MarkSubtreeVisible(int nodeIndex, ObjectStore& objects) {
+    if (nodeIndex < 0 || nodeIndex >= m_bvhNodes.Size()) return;
+    
+    const auto& node = m_bvhNodes[nodeIndex];
+    
+    // Inside the frustum, but distant clutter and occluded nodes still get dropped
+    if (IsRejectedByCandidateMask(nodeIndex) || IsRejectedAsTooSmall(node) || IsRejectedByOcclusion(node)) {
+        return;
+    }
+    
+    if (node.isLeaf) {
+        if (node.objectIndex >= 0 && node.objectIndex < static_cast<int>(objects.Size())) {
+            objects.visible.Set(node.objectIndex);
+        }
+    } else {
+        MarkSubtreeVisible(node.leftChild, objects);
+        MarkSubtreeVisible(node.rightChild, objects);
+    }
+}
+
+void CPUBVHSystem::MultiViewCullBVH(int nodeIndex, uint32_t activeViews, std::vector<uint32_t>& viewMasks) {
+    if (nodeIndex < 0 || nodeIndex >= m_bvhNodes.Size()) return;
+    
+    const auto& node = m_bvhNodes[nodeIndex];
+    
+    // Box is converted once and shared by every view
+    XMVECTOR minBounds = XMLoadFloat3(&node.minBounds);
+    XMVECTOR maxBounds = XMLoadFloat3(&node.maxBounds);
+    XMVECTOR center = XMVectorScale(XMVectorAdd(minBounds, maxBounds), 0.5f);
+    XMVECTOR extent = XMVectorScale(XMVectorSubtract(maxBounds, minBounds), 0.5f);
+    
+    // Only views that accepted the parent need testing - a child box lies inside its parent
+    uint32_t remaining = activeViews;
+    for (int v = 0; remaining != 0; v++, remaining >>= 1) {
+        if ((remaining & 1u) && !m_packedViews[v].IsBoxInFrustum(center, extent)) {
+            activeViews &= ~(1u << v);
+        }
+    }
+    
+    if (activeViews == 0) {
+        return; // Every view rejects this node, skip entire subtree
+    }
+    
+    if (node.isLeaf) {
+        if (node.objectIndex >= 0 && node.objectIndex < static_cast<int>(viewMasks.size())) {
+            viewMasks[node.objectIndex] = activeViews;
+        }
+    } else {
+        MultiViewCullBVH(node.leftChild, activeViews, viewMasks);
+        MultiViewCullBVH(node.rightChild, activeViews, viewMasks);
+    }
+}
@@ -2,6 +2,10 @@
 
 #include "Common.h"
 #include "Structures.h"
+#include "ObjectStore.h"
+#include "HiZPyramid.h"
+#include "FrameArena.h"
+#include "BVHNodePool.h"
 
 // ============================================================================
 // CPU BVH SYSTEM CLASS (Fallback)
@@ -13,17 +17,110 @@ public:
     ~CPUBVHSystem() = default;
 
     // BVH operations
-    void BuildBVH(const std::vector<RenderObject>& objects);
-    void PerformFrustumCulling(const Frustum& frustum, std::vector<RenderObject>& objects);
+    void BuildBVH(const ObjectStore& objects);
+    // Tree over a subset; leaves keep the indices into objects
+    void BuildBVH(const ObjectStore& objects, const std::vector<int>& objectIndices);
+    // Build temporaries come from this arena instead of the heap; nullptr uses the heap
+    void SetFrameArena(FrameArena* arena) { m_frameArena = arena; }
+    
+    // Incremental upkeep between rebuilds. InsertObject links a new leaf in next to
+    // the sibling whose enlargement costs the least surface area; RemoveObject
+    // unlinks the removed object's leaf, if this tree has one, and relabels the leaf
+    // of the object that moved into its index. Only a rebuild keeps nodes in build order.
+    void InsertObject(const ObjectStore& objects, int objectIndex);
+    void RemoveObject(const ObjectRemoval& removal);
+    // Relabels leaves after the store was reordered; the tree itself is unchanged
+    void RemapObjects(const ObjectReorder& reorder);
+    // Object indices in depth-first leaf order, the order traversal reads them in
+    void GetLeafOrder(std::vector<uint32_t>& outOrder) const;
+    
+    // Incremental edits scatter nodes through the pool; compaction copies the tree
+    // back into depth-first order, each left child right after its parent. Node
+    // indices change, object assignments do not. Meant for idle frames.
+    bool NeedsCompaction() const { return m_incrementalNodeChanges >= Config::BVH_COMPACTION_THRESHOLD; }
+    void Compact();
+    
+    // Takes over a tree built elsewhere, e.g. read back from the GPU system, by
+    // swapping pools; nodes already share this layout. Leaves must index objects.
+    void AdoptTree(BVHNodePool& nodes, int rootNode, const ObjectStore& objects);
+    void PerformFrustumCulling(const Frustum& frustum, ObjectStore& objects);
+    // Marks objects inside visible without clearing the rest, so several trees or frusta add up
+    void AccumulateFrustumCulling(const Frustum& frustum, ObjectStore& objects);
+    
+    // Culls up to Config::MAX_CULL_VIEWS frusta in a single traversal.
+    // Bit v of viewMasks[i] is set when object i is inside frustums[v].
+    void PerformMultiViewCulling(const std::vector<Frustum>& frustums, const ObjectStore& objects,
+                                 std::vector<uint32_t>& viewMasks);
+    
+    // Tiered bounding tests: sphere first, AABB only on planes the sphere straddles
+    void SetUseBoundingSpheres(bool enable) { m_useBoundingSpheres = enable; }
+    bool IsUsingBoundingSpheres() const { return m_useBoundingSpheres; }
+    
+    // Exact SAT test for nodes whose radius exceeds sizeRatio * frustum radius
+    void SetUseExactTest(bool enable) { m_useExactTest = enable; }
+    bool IsUsingExactTest() const { return m_useExactTest; }
+    void SetExactTestSizeRatio(float sizeRatio) { m_exactTestSizeRatio = sizeRatio; }
+    
+    // Rejects nodes/objects whose projected size is below params.minPixelSize
+    void SetScreenSizeCulling(const ScreenSizeCullParams& params) { m_screenSize = params; }
+    
+    // Frustum + HiZ traversal: nodes passing the planes are also tested against
+    // the pyramid, so occluded regions are skipped as whole subtrees. nullptr disables.
+    void SetOcclusionPyramid(const HiZPyramid* pyramid) { m_occlusionPyramid = pyramid; }
+    
+    // Pre-filter from a potentially visible set: one bit per object, clear never drawn.
+    // Subtrees without a candidate are skipped before any bounds test. Call again
+    // whenever the mask's contents change; nullptr disables.
+    void SetCandidateMask(const VisibilitySet* mask) { m_candidateMask = mask; m_candidateNodesStale = true; }
     
     // State management
-    bool IsValid() const { return m_rootNode >= 0 && !m_bvhNodes.empty(); }
+    bool IsValid() const { return m_rootNode >= 0 && !m_bvhNodes.Empty(); }
+    const BVHNodePool& GetNodes() const { return m_bvhNodes; }
+    int GetRootNode() const { return m_rootNode; }
+    // -1 when the object has no leaf in this tree, or for the root's parent
+    int GetObjectLeaf(int objectIndex) const {
+        return objectIndex >= 0 && objectIndex < static_cast<int>(m_objectLeaf.size()) ? m_objectLeaf[objectIndex] : -1;
+    }
+    int GetParent(int nodeIndex) const { return m_parents[nodeIndex]; }
+    const CullingStats& GetStats() const { return m_stats; }
 
 private:
-    std::vector<BVHNode> m_bvhNodes;
+    BVHNodePool m_bvhNodes;
+    BVHNodePool m_compactNodes;         // Compaction target, swapped with m_bvhNodes; keeps its chunks between passes
     int m_rootNode = -1;
+    std::vector<int> m_parents;
+    std::vector<int> m_objectLeaf;      // Per object index, -1 when not in this tree
+    int m_incrementalNodeChanges = 0;   // Since the last build or compaction
+    std::vector<PackedFrustum> m_packedViews;
+    FrameArena* m_frameArena = nullptr;
+    bool m_useBoundingSpheres = true;
+    bool m_useExactTest = false;
+    float m_exactTestSizeRatio = Config::SAT_NODE_SIZE_RATIO;
+    ScreenSizeCullParams m_screenSize;
+    const HiZPyramid* m_occlusionPyramid = nullptr;
+    const VisibilitySet* m_candidateMask = nullptr;
+    std::vector<uint8_t> m_nodeHasCandidate;
+    bool m_candidateNodesStale = true;
+    CullingStats m_stats;
     
     // BVH construction helpers
-    int BuildBVHRecursive(std::vector<int>& nodeIndices);
-    void FrustumCullBVH(int nodeIndex, const Frustum& frustum, std::vector<RenderObject>& objects);
+    void BuildFromIndices(const ObjectStore& objects, const int* objectIndices, size_t count);
+    // Sorts [first, last) in place, each half becoming a subtree
+    int BuildBVHRecursive(int* first, int* last);
+    int CopyDepthFirst(int nodeIndex, int parent);
+    BVHNode MakeLeaf(const ObjectStore& objects, int objectIndex) const;
+    int AllocateNode(const BVHNode& node);
+    void FreeNode(int nodeIndex);
+    void RefitAncestors(int nodeIndex);
+    void FrustumCullBVH(int nodeIndex, const Frustum& frustum, ObjectStore& objects);
+    void MarkSubtreeVisible(int nodeIndex, ObjectStore& objects);
+    bool IsRejectedByExactTest(const BVHNode& node, const Frustum& frustum);
+    bool IsRejectedAsTooSmall(const BVHNode& node);
+    bool IsRejectedByOcclusion(const BVHNode& node);
+    bool IsRejectedByCandidateMask(int nodeIndex);
+    // A rotated object's world box can poke into the frustum where the object itself does not
+    bool IsRejectedByOrientedBox(int objectIndex, const Frustum& frustum, const ObjectStore& objects);
+    void UpdateCandidateNodes(size_t objectCount);
+    uint8_t MarkCandidateNodes(int nodeIndex, size_t objectCount);
+    void MultiViewCullBVH(int nodeIndex, uint32_t activeViews, std::vector<uint32_t>& viewMasks);
 };
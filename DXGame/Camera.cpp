@@ -5,7 +5,7 @@ Matrix FPSCamera::GetViewMatrix() const {
 }
 
 Matrix FPSCamera::GetProjectionMatrix(float aspectRatio) const {
-    return Matrix::CreatePerspectiveFieldOfView(XM_PIDIV4, aspectRatio, 0.1f, 1000.0f);
+    return Matrix::CreatePerspectiveFieldOfView(fieldOfView, aspectRatio, nearPlane, farPlane);
 }
 
 void FPSCamera::UpdateVectors() {
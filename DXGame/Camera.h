@@ -19,6 +19,11 @@ public:
     float mouseSensitivity = 0.1f;
     float moveSpeed = 5.0f;
     
+    // Projection parameters
+    float fieldOfView = XM_PIDIV4;  // Vertical, radians
+    float nearPlane = 0.1f;
+    float farPlane = 1000.0f;
+    
     // Camera matrices
     Matrix GetViewMatrix() const;
     Matrix GetProjectionMatrix(float aspectRatio) const;
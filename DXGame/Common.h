@@ -10,6 +10,8 @@
 #include <algorithm>
 #include <chrono>
 #include <utility>
+#include <cstdio>
+#include <random>
 
 // DirectXTK Headers
 #include "SimpleMath.h"
@@ -38,11 +40,76 @@ namespace Config {
     constexpr int MORTON_CODE_RANGE = 1023;
     constexpr int MSAA_SAMPLES = 4;
     constexpr int OCCLUSION_FRAME_THRESHOLD = 1;
+    constexpr int MAX_CULL_VIEWS = 32;                    // Views per batched culling pass (one bit each)
+    constexpr float SAT_NODE_SIZE_RATIO = 0.02f;          // Node radius / frustum radius above which the exact SAT test runs
+    constexpr float MIN_PROJECTED_PIXEL_SIZE = 1.0f;      // Projected diameter (pixels) below which nodes/objects are culled
+    constexpr int STATS_LOG_INTERVAL = 300;               // Frames between culling statistics dumps
+    
+    // Adaptive culling method selection (linear vs BVH)
+    constexpr float CULL_SELECTOR_SMOOTHING = 0.1f;       // Weight of the newest cost sample in the moving average
+    constexpr float CULL_SELECTOR_HYSTERESIS = 0.15f;     // Other method must be this fraction cheaper to win a vote
+    constexpr int CULL_SELECTOR_SWITCH_FRAMES = 30;       // Consecutive winning votes before switching
+    constexpr int CULL_SELECTOR_PROBE_INTERVAL = 120;     // Frames between re-measuring the inactive method
+    
+    // CPU software occlusion culling
+    constexpr int SW_OCCLUSION_WIDTH = 256;               // Depth buffer resolution (width rounded up to a multiple of 4)
+    constexpr int SW_OCCLUSION_HEIGHT = 128;
+    constexpr int MAX_SW_OCCLUDERS = 32;                  // Occluders rasterized per frame (top K by score)
+    constexpr int OCCLUDER_TRIANGLE_BUDGET = 192;         // Front-face triangles per frame across all occluders
+    constexpr int OCCLUDER_PIXEL_BUDGET = 65536;          // Projected depth-buffer pixels per frame (twice the 256x128 target)
+    constexpr float OCCLUDER_MIN_SCREEN_AREA = 16.0f;     // Smaller occluders cost more than they hide
+    constexpr float OCCLUDER_STICKINESS = 0.5f;           // Score bonus for occluders that contributed last frame
+    
+    // Adaptive per-object occlusion queries
+    constexpr int OCCLUSION_QUERY_BUDGET = 512;           // Per-object queries per frame (runtime tunable), hidden objects first
+    constexpr int MAX_OCCLUSION_QUERY_BUDGET = 65536;     // Upper bound of the runtime-tuned budget
+    constexpr int MAX_QUERY_INTERVAL = 16;                // Frames between queries once an object stays visible
+    constexpr float QUERY_RESET_CAMERA_SPEED = 8.0f;      // Units per second of camera movement that reset every interval (walking is 5)
+    constexpr float QUERY_RESET_CAMERA_TURN = 1.5f;       // Radians per second of camera rotation that reset every interval
+    
+    // Hierarchical occlusion query scheduling
+    constexpr int VISIBLE_QUERY_INTERVAL = 8;             // Frames a visible leaf is trusted before a re-check (randomized down to half)
+    constexpr int MAX_MULTI_QUERY_NODES = 8;              // Invisible nodes batched into one query
+    constexpr int MULTI_QUERY_MIN_INVISIBLE_FRAMES = 2;   // Consecutive invisible results before a node is batched
+    constexpr int QUERY_HISTORY_FRAMES = 4;               // Frames out of traversal before a node's visibility is no longer trusted
+    constexpr int SOFTWARE_QUERY_LATENCY = 1;             // Frames before a software query result is ready, like a GPU readback
+    
+    // Precomputed potentially visible sets (static objects)
+    constexpr float PVS_CELL_SIZE = 4.0f;                 // Edge of a baked view cell
+    constexpr float PVS_BAKE_MARGIN = 16.0f;              // Baked volume extends this far past the scene bounds
+    constexpr int PVS_SAMPLES_PER_AXIS = 3;               // Sample points per cell edge, corners included
+    constexpr int PVS_BAKE_WIDTH = 128;                   // Depth buffer per cube face while baking
+    constexpr int PVS_BAKE_HEIGHT = 128;
+    constexpr const char* PVS_CACHE_FILE = "scene.pvs";   // Rebaked when missing or made for another scene
+    
+    // Cell and portal culling
+    constexpr int PORTAL_MAX_DEPTH = 16;                  // Portals followed in one chain from the camera's cell
+    constexpr float PORTAL_NEAR_DISTANCE = 0.5f;          // Closer than this to a portal's opening, all of the screen passes
+    
+    // Visibility reuse across frames
+    constexpr float VISIBILITY_CACHE_BAND = 2.0f;         // Objects this near a frustum plane are re-tested after small camera moves
+    
+    // Runtime spawn/despawn stress test
+    constexpr int SPAWN_CHURN_PER_FRAME = 64;             // Objects spawned, and once at the population the oldest despawned, each frame
+    constexpr int SPAWN_CHURN_POPULATION = 2048;          // Spawned objects alive at once
+    constexpr float SPAWN_CHURN_AREA = 40.0f;             // Width of the field in front of the test cubes
+    
+    // Object bounds
+    constexpr bool KEEP_ORIENTED_BOUNDS = true;           // Store an oriented box per object for a finer leaf-level frustum test
+    constexpr int QUANTIZED_ERROR_SAMPLE_INTERVAL = 30;   // Quantized linear culls between comparisons against float bounds
+    constexpr int OBJECT_REORDER_INTERVAL = 600;          // Frames between passes putting object storage back in traversal order
+    
+    // Per-frame memory
+    constexpr size_t FRAME_ARENA_SIZE = 1 << 20;          // Starting arena block; grows once to the largest frame seen
+    constexpr int FRAME_ALLOCATION_WARMUP_FRAMES = 600;   // Frames before heap allocations in steady state are asserted against
       // Dynamic BVH constants - properly tuned for performance and quality
     constexpr float MOVEMENT_THRESHOLD = 0.01f;           // Minimum movement to trigger refit
     constexpr float REBUILD_THRESHOLD = 2.0f;             // Total movement before full rebuild
     constexpr float BVH_QUALITY_THRESHOLD = 2.0f;        // Surface area expansion ratio for rebuild
     constexpr int MAX_FRAMES_BETWEEN_REBUILDS = 300;     // Force rebuild after N frames (5 seconds at 60fps)
+    constexpr int GPU_BVH_EDIT_REBUILD_INTERVAL = 30;    // Min frames between GPU BVH rebuilds for spawns and despawns
     constexpr float SCENE_BOUNDS_PADDING = 0.1f;         // Padding factor for scene bounds
     constexpr int BVH_REFIT_ITERATIONS = 3;              // Bottom-up refit iterations for convergence
+    constexpr int BVH_NODE_CHUNK_SHIFT = 10;             // CPU BVH nodes are pooled in chunks of 1 << shift
+    constexpr int BVH_COMPACTION_THRESHOLD = 256;        // Nodes allocated or freed incrementally before an idle frame re-lays the tree
 }
@@ -0,0 +1,69 @@
+#include "CullingSelector.h"
+
+CullingMethod CullingSelector::SelectMethod() {
+    CullingMethod inactive = Other(m_activeMethod);
+    
+    // Probe the inactive method until it has a sample, then periodically
+    if (!m_hasSample[Index(inactive)] || ++m_framesSinceProbe >= Config::CULL_SELECTOR_PROBE_INTERVAL) {
+        m_framesSinceProbe = 0;
+        return inactive;
+    }
+    
+    return m_activeMethod;
+}
+
+void CullingSelector::RecordCullingCost(CullingMethod method, float milliseconds) {
+    int index = Index(method);
+    if (!m_hasSample[index]) {
+        m_cullCost[index] = milliseconds;
+        m_hasSample[index] = true;
+    } else {
+        m_cullCost[index] += (milliseconds - m_cullCost[index]) * Config::CULL_SELECTOR_SMOOTHING;
+    }
+    
+    // Culling is the last measurement of the frame
+    EvaluateSwitch();
+}
+
+void CullingSelector::RecordRebuildCost(float milliseconds) {
+    m_rebuildCost = milliseconds;
+}
+
+void CullingSelector::RecordMaintenanceDemand(bool rebuildNeeded) {
+    // Charged whether or not the rebuild actually ran, so the BVH estimate
+    // stays honest while the linear path is active and upkeep is deferred
+    float frameCost = rebuildNeeded ? m_rebuildCost : 0.0f;
+    m_maintenanceCost += (frameCost - m_maintenanceCost) * Config::CULL_SELECTOR_SMOOTHING;
+}
+
+float CullingSelector::GetEstimatedCost(CullingMethod method) const {
+    float cost = m_cullCost[Index(method)];
+    if (method == CullingMethod::Hierarchical) {
+        cost += m_maintenanceCost;
+    }
+    return cost;
+}
+
+void CullingSelector::EvaluateSwitch() {
+    CullingMethod inactive = Other(m_activeMethod);
+    if (!m_hasSample[0] || !m_hasSample[1]) return;
+    
+    float activeCost = GetEstimatedCost(m_activeMethod);
+    float inactiveCost = GetEstimatedCost(inactive);
+    
+    // Margin plus dwell time keeps near-equal costs from flip-flopping
+    if (inactiveCost < activeCost * (1.0f - Config::CULL_SELECTOR_HYSTERESIS)) {
+        m_switchVotes++;
+    } else {
+        m_switchVotes = 0;
+    }
+    
+    if (m_switchVotes >= Config::CULL_SELECTOR_SWITCH_FRAMES) {
+        m_activeMethod = inactive;
+        m_switchVotes = 0;
+        m_framesSinceProbe = 0;
+        OutputDebugStringA(m_activeMethod == CullingMethod::Linear ?
+            "Culling selector: switched to linear SIMD culling\n" :
+            "Culling selector: switched to BVH culling\n");
+    }
+}
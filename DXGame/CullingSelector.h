@@ -0,0 +1,49 @@
+#pragma once
+
+#include "Common.h"
+
+// ============================================================================
+// ADAPTIVE CULLING SELECTOR CLASS
+// ============================================================================
+
+enum class CullingMethod {
+    Hierarchical,   // CPUBVHSystem traversal, pays for tree upkeep
+    Linear          // LinearCullingSystem streaming pass, no upkeep
+};
+
+// Measures both CPU culling paths online and picks the cheaper one per frame.
+// BVH cost = traversal + per-frame rebuild demand; switching needs the other
+// method to stay cheaper by a margin for several frames (hysteresis).
+class CullingSelector {
+public:
+    CullingSelector() = default;
+    ~CullingSelector() = default;
+
+    // Method to run this frame - occasionally the inactive one, to refresh its estimate
+    CullingMethod SelectMethod();
+    
+    // Per-frame measurements
+    void RecordCullingCost(CullingMethod method, float milliseconds);
+    void RecordRebuildCost(float milliseconds);
+    void RecordMaintenanceDemand(bool rebuildNeeded);
+    
+    // State queries
+    CullingMethod GetActiveMethod() const { return m_activeMethod; }
+    float GetEstimatedCost(CullingMethod method) const;
+    
+private:
+    float m_cullCost[2] = { 0.0f, 0.0f };
+    bool m_hasSample[2] = { false, false };
+    float m_rebuildCost = 0.0f;         // Last measured BVH rebuild
+    float m_maintenanceCost = 0.0f;     // Moving average of rebuild cost per frame
+    
+    CullingMethod m_activeMethod = CullingMethod::Hierarchical;
+    int m_framesSinceProbe = 0;
+    int m_switchVotes = 0;
+    
+    static int Index(CullingMethod method) { return method == CullingMethod::Linear ? 1 : 0; }
+    static CullingMethod Other(CullingMethod method) {
+        return method == CullingMethod::Linear ? CullingMethod::Hierarchical : CullingMethod::Linear;
+    }
+    void EvaluateSwitch();
+};
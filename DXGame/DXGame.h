@@ -5,6 +5,17 @@
 #include "Camera.h"
 #include "GPUBVHSystem.h"
 #include "CPUBVHSystem.h"
+#include "LinearCullingSystem.h"
+#include "CullingSelector.h"
+#include "SoftwareOcclusionCuller.h"
+#include "OcclusionQueryScheduler.h"
+#include "OcclusionQueryRing.h"
+#include "PotentiallyVisibleSet.h"
+#include "PVSBaker.h"
+#include "PortalSystem.h"
+#include "VisibilityCache.h"
+#include "FrameArena.h"
+#include <deque>
 
 // ============================================================================
 // MAIN APPLICATION CLASS
@@ -21,6 +32,11 @@ public:
     void Render();
     void OnResize(int width, int height);
 
+    // Runtime object lifetime. A handle stays valid until its object is despawned;
+    // dense indices do not, removal moves the last object into the hole.
+    ObjectHandle SpawnObject(const RenderObject& object);
+    bool DespawnObject(ObjectHandle handle);
+
 private:
     // Window and device
     HWND m_hwnd = nullptr;
@@ -45,19 +61,92 @@ private:
     DirectX::Mouse::ButtonStateTracker m_mouseTracker;
     
     // Render objects and culling
-    std::vector<RenderObject> m_objects;
+    ObjectStore m_objects;
+    std::vector<uint32_t> m_movedObjects;       // Bounds refreshed in one batch after animating
     Frustum m_frustum;
+    Matrix m_viewProjection;
+    ScreenSizeCullParams m_screenSizeParams;
+    float m_minPixelSize = Config::MIN_PROJECTED_PIXEL_SIZE;
     
     // BVH systems
     std::unique_ptr<GPUBVHSystem> m_gpuBVH;
     std::unique_ptr<CPUBVHSystem> m_cpuBVH;
+    BVHNodePool m_bvhReadback;        // GPU-built tree on its way to the CPU BVH
     bool m_useGPUBVH = true;
     bool m_bvhNeedsRebuild = true;
+    
+    // CPU culling method selection (brute-force vs hierarchical)
+    std::unique_ptr<LinearCullingSystem> m_linearCuller;
+    CullingSelector m_cullingSelector;
+    CullingMethod m_cullingMethod = CullingMethod::Hierarchical;
+    bool m_cpuBVHStale = false;       // Rebuild deferred while linear culling was active
+    
+    // Same-frame CPU occlusion culling
+    std::unique_ptr<SoftwareOcclusionCuller> m_softwareOcclusion;
+    HiZPyramid m_hizPyramid;
+    OcclusionMode m_occlusionMode = OcclusionMode::PerObject;
+    bool m_occlusionDoneInTraversal = false;   // HiZ traversal already removed occluded objects this frame
+    
+    // Hardware occlusion queries: per object, or scheduled over a hierarchy
+    std::unique_ptr<D3DOcclusionQueryBackend> m_d3dQueryBackend;
+    std::unique_ptr<SoftwareOcclusionQueryBackend> m_softwareQueryBackend;
+    std::unique_ptr<OcclusionQueryScheduler> m_queryScheduler;
+    QuerySchedulingMode m_queryMode = QuerySchedulingMode::PerObject;
+    OcclusionQueryRing m_pendingQueries;            // Per-object queries in issue order
+    int m_queryBudget = Config::OCCLUSION_QUERY_BUDGET;
+    QueryFrequencyStats m_queryStats;
+    Vector3 m_lastQueryCameraPosition;
+    Vector3 m_lastQueryCameraForward = Vector3(0, 0, 1);
+    ComPtr<ID3D11BlendState> m_noColorWriteState;   // Depth-only re-tests of hidden objects
     Vector3 m_sceneMinBounds, m_sceneMaxBounds;
     
+    // Baked static visibility, looked up by camera cell before culling
+    PotentiallyVisibleSet m_pvs;
+    bool m_usePVS = true;
+    int m_pvsCell = -1;
+    int m_pvsCandidates = 0;
+    VisibilitySet m_pvsMask;                    // Empty when the camera is outside the baked volume
+    uint32_t m_pvsMaskLayout = 0;               // Store layout the mask was decoded for
+    bool m_pvsDoneInTraversal = false;          // CPU BVH already skipped non-candidates this frame
+    
+    // Rooms and doorways; replaces whole-scene culling while the camera is inside a cell
+    PortalSystem m_portalSystem;
+    bool m_usePortals = true;
+    bool m_portalCullingDone = false;
+    
+    // Culling results carried over between frames
+    VisibilityCache m_visibilityCache;
+    uint32_t m_sceneGeneration = 0;             // Bumped when culling inputs other than the camera change
+    
+    // Spawn/despawn stress test, oldest first
+    bool m_spawnChurn = false;
+    std::deque<ObjectHandle> m_spawnedObjects;
+    std::mt19937 m_spawnRandom{ 24680u };
+    ObjectLifetimeStats m_lifetimeStats;
+    
+    // Object storage periodically put back in traversal order, so culling and drawing stream it
+    bool m_reorderObjects = true;
+    int m_lastReorderFrame = 0;
+    uint32_t m_reorderedLayout = 0;             // Store layout the last reorder produced
+    std::vector<uint32_t> m_reorderOrder;
+    ObjectReorder m_reorder;
+    ObjectReorderStats m_reorderStats;
+    
+    // Per-frame temporaries, released when the next frame starts
+    FrameArena m_frameArena;
+    uint64_t m_frameStartHeapAllocations = 0;
+    uint32_t m_frameStartLayout = 0;            // What the last frame started with; a change means it was not steady
+    uint32_t m_frameStartGeneration = 0;
+    CullingMethod m_frameStartCullingMethod = CullingMethod::Hierarchical;
+    QuerySchedulingMode m_frameStartQueryMode = QuerySchedulingMode::PerObject;
+    size_t m_frameStartQueryCapacity = 0;       // Query pool plus ring; both grow only to a new in-flight high
+    bool m_frameMaintenance = false;            // Idle-frame upkeep ran, which may allocate
+    FrameMemoryStats m_frameMemoryStats;
+    
     // Timing
     std::chrono::high_resolution_clock::time_point m_lastTime;
     float m_deltaTime = 0.0f;
+    int m_frameIndex = 0;
     
     // Window dimensions
     int m_width = 1024;
@@ -69,22 +158,35 @@ private:
     bool CreateDepthStencilView();
     bool InitializeDirectXTK();
     bool CreateRenderObjects();
+    void CreateInteriorWing();
     bool InitializeBVHSystems();
+    void InitializePotentiallyVisibleSets();
       // Update methods
     void UpdateInput();
     void UpdateCamera();
     void UpdateFrustum();
     void UpdateBVH();
+    void UpdateCPUBVH(bool rebuildNeeded);
+    void CompactCPUBVHWhenIdle();
+    void ReorderObjectStorage();
     void UpdateCulling();
     void UpdateDynamicObjects();  // New method for object animation
     void UpdateSceneBounds();  // Dynamic scene bounds calculation
+    void UpdateSpawnChurn();
+    void BeginFrameAllocations();
     
     // Culling methods
     void PerformCulling();
+    void UpdatePotentiallyVisibleSet();
+    void ApplyPotentiallyVisibleSet();
+    void PerformCPUCulling();
+    void PerformSoftwareOcclusion();
+    bool PrepareOcclusionPyramid();
     void ProcessOcclusionQueries();
+    void UpdateQueryIntervals();
+    void ScheduleHierarchicalQueries();
+    void SetQueryMode(QuerySchedulingMode mode);
+    void LogCullingStats();
       // Utility methods
     void CalculateSceneBounds();
-    void CreateOcclusionQueries();
-    void UpdateObjectBounds(RenderObject& obj);  // Update bounds from world matrix
-    Vector3 GetObjectPosition(const Matrix& worldMatrix);  // Extract position from matrix
 };
@@ -25,6 +25,7 @@ bool DXGame::Initialize(HWND hwnd, int width, int height) {
 
     // Calculate scene bounds for BVH construction
     CalculateSceneBounds();
+    InitializePotentiallyVisibleSets();
 
     // Set initial viewport
     D3D11_VIEWPORT viewport = {};
@@ -119,92 +120,132 @@ bool DXGame::InitializeDirectXTK() {
     m_mouse->SetWindow(m_hwnd);
     m_effect->EnableDefaultLighting();
 
+    // Objects hidden by their occlusion query are re-tested without touching colour or depth
+    D3D11_BLEND_DESC blendDesc = {};
+    blendDesc.RenderTarget[0].BlendEnable = FALSE;
+    blendDesc.RenderTarget[0].RenderTargetWriteMask = 0;
+    HRESULT hr = m_device->CreateBlendState(&blendDesc, &m_noColorWriteState);
+    if (FAILED(hr)) {
+        OutputDebugStringA("Failed to create depth-only blend state\n");
+        return false;
+    }
+
     return true;
 }
 
 bool DXGame::CreateRenderObjects() {
     // Create test cubes arranged vertically for better occlusion testing
-    m_objects.resize(12);  // Increased to include dynamic objects
+    m_objects.Clear();
+
+    // Every cube is a solid occluder; the box must stay inside the drawn unit cube
+    auto makeCube = [](const Vector3& position) {
+        RenderObject obj;
+        obj.position = position;
+        obj.occluderHalfSize = Vector3(0.5f, 0.5f, 0.5f);
+        return obj;
+    };
 
     // Bottom row cubes (Y = -2) - these should occlude upper cubes when looking from below
-    m_objects[0].world = Matrix::CreateTranslation(Vector3(-4, -2, 10));
-    m_objects[0].minBounds = Vector3(-5, -3, 9);
-    m_objects[0].maxBounds = Vector3(-3, -1, 11);
-    m_objects[0].baseSize = Vector3(2, 2, 2);
-
-    m_objects[1].world = Matrix::CreateTranslation(Vector3(0, -2, 10));
-    m_objects[1].minBounds = Vector3(-1, -3, 9);
-    m_objects[1].maxBounds = Vector3(1, -1, 11);
-    m_objects[1].baseSize = Vector3(2, 2, 2);
-
-    m_objects[2].world = Matrix::CreateTranslation(Vector3(4, -2, 10));
-    m_objects[2].minBounds = Vector3(3, -3, 9);
-    m_objects[2].maxBounds = Vector3(5, -1, 11);
-    m_objects[2].baseSize = Vector3(2, 2, 2);
+    m_objects.Add(makeCube(Vector3(-4, -2, 10)));
+    m_objects.Add(makeCube(Vector3(0, -2, 10)));
+    m_objects.Add(makeCube(Vector3(4, -2, 10)));
 
     // Middle row cubes (Y = 0)
-    m_objects[3].world = Matrix::CreateTranslation(Vector3(-4, 0, 10));
-    m_objects[3].minBounds = Vector3(-5, -1, 9);
-    m_objects[3].maxBounds = Vector3(-3, 1, 11);
-    m_objects[3].baseSize = Vector3(2, 2, 2);
-
-    m_objects[4].world = Matrix::CreateTranslation(Vector3(0, 0, 10));
-    m_objects[4].minBounds = Vector3(-1, -1, 9);
-    m_objects[4].maxBounds = Vector3(1, 1, 11);
-    m_objects[4].baseSize = Vector3(2, 2, 2);
-
-    m_objects[5].world = Matrix::CreateTranslation(Vector3(4, 0, 10));
-    m_objects[5].minBounds = Vector3(3, -1, 9);
-    m_objects[5].maxBounds = Vector3(5, 1, 11);
-    m_objects[5].baseSize = Vector3(2, 2, 2);
+    m_objects.Add(makeCube(Vector3(-4, 0, 10)));
+    m_objects.Add(makeCube(Vector3(0, 0, 10)));
+    m_objects.Add(makeCube(Vector3(4, 0, 10)));
 
     // Top row cubes (Y = 2) - these should be occluded when looking from below
-    m_objects[6].world = Matrix::CreateTranslation(Vector3(-4, 2, 10));
-    m_objects[6].minBounds = Vector3(-5, 1, 9);
-    m_objects[6].maxBounds = Vector3(-3, 3, 11);
-    m_objects[6].baseSize = Vector3(2, 2, 2);
-
-    m_objects[7].world = Matrix::CreateTranslation(Vector3(0, 2, 10));
-    m_objects[7].minBounds = Vector3(-1, 1, 9);
-    m_objects[7].maxBounds = Vector3(1, 3, 11);
-    m_objects[7].baseSize = Vector3(2, 2, 2);
-
-    m_objects[8].world = Matrix::CreateTranslation(Vector3(4, 2, 10));
-    m_objects[8].minBounds = Vector3(3, 1, 9);
-    m_objects[8].maxBounds = Vector3(5, 3, 11);
-    m_objects[8].baseSize = Vector3(2, 2, 2);    // Dynamic objects - circular moving cubes for testing
-    m_objects[9].world = Matrix::CreateTranslation(Vector3(-8, 0, 15));
-    m_objects[9].baseSize = Vector3(2, 2, 2);
-    m_objects[9].isDynamic = true;
-    m_objects[9].animationCenter = Vector3(-8, 0, 15);  // Center of circular motion
-    m_objects[9].animationRadius = 3.0f;  // Radius of 3 units
-    m_objects[9].animationTime = 0.0f;
-    m_objects[9].UpdateBounds();
-
-    m_objects[10].world = Matrix::CreateTranslation(Vector3(8, 0, 15));
-    m_objects[10].baseSize = Vector3(2, 2, 2);
-    m_objects[10].isDynamic = true;
-    m_objects[10].animationCenter = Vector3(8, 0, 15);  // Center of circular motion
-    m_objects[10].animationRadius = 4.0f;  // Radius of 4 units
-    m_objects[10].animationTime = 1.57f;  // Start at 90 degrees offset
-    m_objects[10].UpdateBounds();
-
-    m_objects[11].world = Matrix::CreateTranslation(Vector3(0, 4, 12));
-    m_objects[11].baseSize = Vector3(2, 2, 2);
-    m_objects[11].isDynamic = true;
-    m_objects[11].animationCenter = Vector3(0, 4, 12);  // Center of circular motion
-    m_objects[11].animationRadius = 2.5f;  // Radius of 2.5 units
-    m_objects[11].animationTime = 3.14f;  // Start at 180 degrees offset
-    m_objects[11].UpdateBounds();
-
-    CreateOcclusionQueries();
+    m_objects.Add(makeCube(Vector3(-4, 2, 10)));
+    m_objects.Add(makeCube(Vector3(0, 2, 10)));
+    m_objects.Add(makeCube(Vector3(4, 2, 10)));
+
+    // Dynamic objects - circular moving cubes for testing
+    RenderObject dynamicCube = makeCube(Vector3(-8, 0, 15));
+    dynamicCube.isDynamic = true;
+    dynamicCube.animationCenter = Vector3(-8, 0, 15);  // Center of circular motion
+    dynamicCube.animationRadius = 3.0f;  // Radius of 3 units
+    dynamicCube.animationTime = 0.0f;
+    m_objects.Add(dynamicCube);
+
+    dynamicCube = makeCube(Vector3(8, 0, 15));
+    dynamicCube.isDynamic = true;
+    dynamicCube.animationCenter = Vector3(8, 0, 15);  // Center of circular motion
+    dynamicCube.animationRadius = 4.0f;  // Radius of 4 units
+    dynamicCube.animationTime = 1.57f;  // Start at 90 degrees offset
+    m_objects.Add(dynamicCube);
+
+    dynamicCube = makeCube(Vector3(0, 4, 12));
+    dynamicCube.isDynamic = true;
+    dynamicCube.animationCenter = Vector3(0, 4, 12);  // Center of circular motion
+    dynamicCube.animationRadius = 2.5f;  // Radius of 2.5 units
+    dynamicCube.animationTime = 3.14f;  // Start at 180 degrees offset
+    m_objects.Add(dynamicCube);
+
+    CreateInteriorWing();
     return true;
 }
 
+void DXGame::CreateInteriorWing() {
+    // Three rooms in a row behind the start position, each opening into the next
+    // through a doorway. The yard is in no cell: a camera out there takes the
+    // normal culling path, and from inside the wing the yard's objects are
+    // culled with the camera frustum like any object outside the cells.
+    auto addBox = [this](const Vector3& center, const Vector3& size) {
+        RenderObject obj;
+        obj.position = center;
+        obj.scale = size;
+        obj.occluderHalfSize = size * 0.5f;
+        m_objects.Add(obj);
+    };
+
+    const float roomDepth = 12.0f;
+    const float frontZ = -6.0f;
+    const float backZ = frontZ - roomDepth * 3.0f;
+    const float midZ = (frontZ + backZ) * 0.5f;
+    const float shellLength = roomDepth * 3.0f + 1.0f;
+
+    // Shell: floor, ceiling, side walls and back wall, one unit thick
+    addBox(Vector3(0, -3.5f, midZ), Vector3(13, 1, shellLength));
+    addBox(Vector3(0, 5.5f, midZ), Vector3(13, 1, shellLength));
+    addBox(Vector3(-6, 1, midZ), Vector3(1, 8, shellLength));
+    addBox(Vector3(6, 1, midZ), Vector3(1, 8, shellLength));
+    addBox(Vector3(0, 1, backZ), Vector3(13, 8, 1));
+
+    int previousCell = -1;
+
+    for (int room = 0; room < 3; room++) {
+        float wallZ = frontZ - roomDepth * room;
+        float centerZ = wallZ - roomDepth * 0.5f;
+
+        // Partition with a doorway x [-1.5, 1.5], y [-3, 1]: two side pieces and a lintel
+        addBox(Vector3(-3.75f, 1, wallZ), Vector3(4.5f, 8, 1));
+        addBox(Vector3(3.75f, 1, wallZ), Vector3(4.5f, 8, 1));
+        addBox(Vector3(0, 3, wallZ), Vector3(3, 4, 1));
+
+        // Furniture
+        for (int x = -1; x <= 1; x++) {
+            for (int z = -1; z <= 1; z++) {
+                addBox(Vector3(x * 3.0f, -2.5f, centerZ + z * 3.0f), Vector3(1, 1, 1));
+            }
+        }
+
+        int cell = m_portalSystem.AddCell(Vector3(-6, -3, wallZ - roomDepth), Vector3(6, 5, wallZ));
+        Vector3 doorway[4] = {
+            Vector3(-1.5f, -3, wallZ), Vector3(1.5f, -3, wallZ),
+            Vector3(1.5f, 1, wallZ), Vector3(-1.5f, 1, wallZ)
+        };
+        if (previousCell >= 0) {
+            m_portalSystem.AddPortal(previousCell, cell, doorway);
+        }
+        previousCell = cell;
+    }
+}
+
 bool DXGame::InitializeBVHSystems() {
     // Try to initialize GPU BVH system first
     m_gpuBVH = std::make_unique<GPUBVHSystem>();
-    if (m_gpuBVH->Initialize(m_device, m_context, static_cast<int>(m_objects.size()))) {
+    if (m_gpuBVH->Initialize(m_device, m_context, static_cast<int>(m_objects.Size()))) {
         m_useGPUBVH = true;
         OutputDebugStringA("Using GPU BVH system\n");
     } else {
@@ -215,23 +256,75 @@ bool DXGame::InitializeBVHSystems() {
 
     // Always create CPU BVH as fallback
     m_cpuBVH = std::make_unique<CPUBVHSystem>();
+    m_cpuBVH->SetFrameArena(&m_frameArena);      // Rebuilt every frame while objects move
+    m_linearCuller = std::make_unique<LinearCullingSystem>();
+    m_softwareOcclusion = std::make_unique<SoftwareOcclusionCuller>();
+
+    // Scheduled occlusion queries; the software backend answers them from the CPU depth buffer
+    m_d3dQueryBackend = std::make_unique<D3DOcclusionQueryBackend>();
+    if (!m_d3dQueryBackend->Initialize(m_device, m_context, m_states.get())) {
+        m_d3dQueryBackend.reset();
+        OutputDebugStringA("Hardware query backend not available, scheduled queries use the software backend\n");
+    }
+    m_softwareQueryBackend = std::make_unique<SoftwareOcclusionQueryBackend>(*m_softwareOcclusion);
+    m_queryScheduler = std::make_unique<OcclusionQueryScheduler>();
+    // Per-object queries draw the real mesh, so they need the hardware backend
+    m_pendingQueries.SetBackend(m_d3dQueryBackend.get());
+
+    m_portalSystem.Build(m_objects);
 
     return true;
 }
 
+void DXGame::InitializePotentiallyVisibleSets() {
+    // Baking is an offline step; the result is cached and reused until the scene changes
+    if (m_pvs.LoadFromFile(Config::PVS_CACHE_FILE) && m_pvs.Matches(m_objects)) {
+        m_pvs.BindObjects(m_objects);
+        char buffer[160];
+        snprintf(buffer, sizeof(buffer), "PVS loaded: %d cells, %d bytes\n",
+            static_cast<int>(m_pvs.GetCellCount()), static_cast<int>(m_pvs.GetCompressedBytes()));
+        OutputDebugStringA(buffer);
+        return;
+    }
+
+    // The camera starts outside the objects' bounds, so the cells reach past them
+    Vector3 margin(Config::PVS_BAKE_MARGIN, Config::PVS_BAKE_MARGIN, Config::PVS_BAKE_MARGIN);
+    PVSBaker baker;
+    if (!baker.Bake(m_objects, m_sceneMinBounds - margin, m_sceneMaxBounds + margin, Config::PVS_CELL_SIZE, m_pvs)) {
+        m_pvs.Clear();
+        OutputDebugStringA("PVS bake failed, culling without it\n");
+        return;
+    }
+
+    m_pvs.BindObjects(m_objects);
+
+    const PVSBakeStats& stats = baker.GetStats();
+    char buffer[256];
+    snprintf(buffer, sizeof(buffer),
+        "PVS baked: %.1f ms, %d cells (%d distinct sets), %d sample points, %.1f of %d static objects per cell, "
+        "%d bytes (%d uncompressed)\n",
+        stats.bakeTimeMs, stats.cells, stats.distinctSets, stats.samplePoints, stats.averageVisible, stats.staticObjects,
+        stats.compressedBytes, stats.uncompressedBytes);
+    OutputDebugStringA(buffer);
+
+    if (!m_pvs.SaveToFile(Config::PVS_CACHE_FILE)) {
+        OutputDebugStringA("Failed to write PVS cache file\n");
+    }
+}
+
 void DXGame::CalculateSceneBounds() {
-    if (m_objects.empty()) {
+    if (m_objects.Empty()) {
         m_sceneMinBounds = Vector3::Zero;
         m_sceneMaxBounds = Vector3::Zero;
         return;
     }
 
-    m_sceneMinBounds = m_objects[0].minBounds;
-    m_sceneMaxBounds = m_objects[0].maxBounds;
+    m_sceneMinBounds = m_objects.bounds[0].minBounds;
+    m_sceneMaxBounds = m_objects.bounds[0].maxBounds;
 
-    for (size_t i = 1; i < m_objects.size(); ++i) {
-        m_sceneMinBounds = Vector3::Min(m_sceneMinBounds, m_objects[i].minBounds);
-        m_sceneMaxBounds = Vector3::Max(m_sceneMaxBounds, m_objects[i].maxBounds);
+    for (size_t i = 1; i < m_objects.Size(); ++i) {
+        m_sceneMinBounds = Vector3::Min(m_sceneMinBounds, m_objects.bounds[i].minBounds);
+        m_sceneMaxBounds = Vector3::Max(m_sceneMaxBounds, m_objects.bounds[i].maxBounds);
     }
 
     // Add some padding to avoid edge cases
@@ -241,27 +334,25 @@ void DXGame::CalculateSceneBounds() {
 }
 
 void DXGame::UpdateSceneBounds() {
-    if (m_objects.empty()) {
+    if (m_objects.Empty()) {
         m_sceneMinBounds = Vector3::Zero;
         m_sceneMaxBounds = Vector3::Zero;
         return;
     }
 
     // Initialize with first object's bounds
-    m_sceneMinBounds = m_objects[0].minBounds;
-    m_sceneMaxBounds = m_objects[0].maxBounds;
+    m_sceneMinBounds = m_objects.bounds[0].minBounds;
+    m_sceneMaxBounds = m_objects.bounds[0].maxBounds;
 
     // Expand bounds to encompass all objects
-    for (size_t i = 1; i < m_objects.size(); ++i) {
-        const auto& obj = m_objects[i];
-        
+    for (size_t i = 1; i < m_objects.Size(); ++i) {
         // Use current bounds for static objects, predicted bounds for dynamic objects
-        Vector3 objMinBounds = obj.minBounds;
-        Vector3 objMaxBounds = obj.maxBounds;
+        Vector3 objMinBounds = m_objects.bounds[i].minBounds;
+        Vector3 objMaxBounds = m_objects.bounds[i].maxBounds;
         
-        if (obj.isDynamic) {
+        if (m_objects.dynamic[i]) {
             // Add velocity-based prediction for fast-moving objects
-            Vector3 velocityPadding = obj.velocity * 0.1f; // 100ms prediction
+            Vector3 velocityPadding = m_objects.motion[i].velocity * 0.1f; // 100ms prediction
             objMinBounds = Vector3::Min(objMinBounds, objMinBounds + velocityPadding);
             objMaxBounds = Vector3::Max(objMaxBounds, objMaxBounds + velocityPadding);
         }
@@ -277,10 +368,10 @@ void DXGame::UpdateSceneBounds() {
     // Additional padding for scenes with many dynamic objects
     int dynamicObjectCount = 0;
     float maxVelocity = 0.0f;
-    for (const auto& obj : m_objects) {
-        if (obj.isDynamic) {
+    for (size_t i = 0; i < m_objects.Size(); ++i) {
+        if (m_objects.dynamic[i]) {
             dynamicObjectCount++;
-            maxVelocity = std::max(maxVelocity, obj.velocity.Length());
+            maxVelocity = std::max(maxVelocity, m_objects.motion[i].velocity.Length());
         }
     }
     
@@ -302,34 +393,3 @@ void DXGame::UpdateSceneBounds() {
         m_sceneMaxBounds = center + halfMinSize;
     }
 }
-
-void DXGame::CreateOcclusionQueries() {
-    D3D11_QUERY_DESC queryDesc = {};
-    queryDesc.Query = D3D11_QUERY_OCCLUSION;
-
-    for (auto& obj : m_objects) {
-        HRESULT hr = m_device->CreateQuery(&queryDesc, &obj.occlusionQuery);
-        if (FAILED(hr)) {
-            OutputDebugStringA("Failed to create occlusion query\n");
-            return;
-        }
-
-        // Initialize all objects as visible
-        obj.visible = true;
-        obj.occludedFrameCount = 0;
-    }
-}
-
-void DXGame::UpdateObjectBounds(RenderObject& obj) {
-    // Extract position from world matrix
-    Vector3 position = GetObjectPosition(obj.world);
-    
-    // Update bounding box based on object's base size and current position
-    Vector3 halfSize = obj.baseSize * 0.5f;
-    obj.minBounds = position - halfSize;
-    obj.maxBounds = position + halfSize;
-}
-
-Vector3 DXGame::GetObjectPosition(const Matrix& worldMatrix) {
-    return Vector3(worldMatrix._41, worldMatrix._42, worldMatrix._43);
-}
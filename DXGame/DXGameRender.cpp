@@ -27,48 +27,95 @@ void DXGame::Render() {
     m_effect->SetProjection(projection);
 
     // Sort objects front-to-back for better occlusion culling
-    std::vector<std::pair<float, int>> depthSortedObjects;
-    for (int i = 0; i < m_objects.size(); ++i) {
-        if (m_objects[i].visible) {
-            // Calculate distance from camera to object center
-            Vector3 objectCenter = (m_objects[i].minBounds + m_objects[i].maxBounds) * 0.5f;
-            Vector3 toObject = objectCenter - m_camera.position;
-            float distance = toObject.LengthSquared(); // Use squared distance to avoid sqrt
-            depthSortedObjects.push_back({ distance, i });
-        }
-    }
+    ArenaAllocator<std::pair<float, int>> arenaAllocator(&m_frameArena);
+    ArenaVector<std::pair<float, int>> depthSortedObjects(arenaAllocator);
+    depthSortedObjects.reserve(m_objects.visible.Count());
+    m_objects.visible.ForEachSet([&](size_t i) {
+        // Calculate distance from camera to object center
+        const ObjectBounds& bounds = m_objects.bounds[i];
+        Vector3 objectCenter = (bounds.minBounds + bounds.maxBounds) * 0.5f;
+        Vector3 toObject = objectCenter - m_camera.position;
+        float distance = toObject.LengthSquared(); // Use squared distance to avoid sqrt
+        depthSortedObjects.push_back({ distance, static_cast<int>(i) });
+    });
 
     // Sort front-to-back (closest first)
     std::sort(depthSortedObjects.begin(), depthSortedObjects.end());
 
+    // Per-object queries run only when due and within the budget. Hidden objects get
+    // their share first: a missed re-test there is an object that stays missing.
+    bool perObjectQueries = m_queryMode == QuerySchedulingMode::PerObject;
+    int hiddenRetestsDue = 0;
+    if (perObjectQueries) {
+        m_queryStats.queriesIssued = 0;
+        m_queryStats.hiddenRetests = 0;
+        m_queryStats.queriesDeferred = 0;
+        for (const auto& obj : m_objects.queries) {
+            if (obj.queryHidden && !obj.queryInProgress && obj.nextQueryFrame <= m_frameIndex) {
+                hiddenRetestsDue++;
+            }
+        }
+    }
+    int visibleQueryBudget = std::max(m_queryBudget - hiddenRetestsDue, 0);
+
     // Render all frustum-culled objects in front-to-back order for occlusion culling
     for (const auto& sortedObj : depthSortedObjects) {
-        auto& obj = m_objects[sortedObj.second];
+        auto& obj = m_objects.queries[sortedObj.second];
 
         // Start occlusion query for this object (for next frame)
-        bool shouldStartQuery = obj.occlusionQuery && !obj.queryInProgress;
+        bool queryDue = perObjectQueries && !obj.queryInProgress && obj.nextQueryFrame <= m_frameIndex;
+        bool shouldStartQuery = queryDue && m_queryStats.queriesIssued < visibleQueryBudget;
+        if (queryDue && !shouldStartQuery) {
+            m_queryStats.queriesDeferred++;
+        }
 
+        OcclusionQueryHandle query = INVALID_OCCLUSION_QUERY;
         if (shouldStartQuery) {
-            m_context->Begin(obj.occlusionQuery.Get());
-            obj.queryInProgress = true;
+            query = m_pendingQueries.Begin(sortedObj.second, m_frameIndex);
+            if (query != INVALID_OCCLUSION_QUERY) {
+                obj.queryInProgress = true;
+                m_queryStats.queriesIssued++;
+            }
         }
 
         // Render the object
-        m_cube->Draw(obj.world, view, projection);
+        // The world matrix exists only for the draw
+        m_cube->Draw(m_objects.GetWorldMatrix(sortedObj.second), view, projection);
 
         // End occlusion query
-        if (shouldStartQuery) {
-            m_context->End(obj.occlusionQuery.Get());
-        }
+        m_pendingQueries.End(query);
     }
 
-    // Reset occlusion query state for objects not rendered (outside frustum)
-    for (auto& obj : m_objects) {
-        if (!obj.visible && obj.queryInProgress) {
-            obj.queryInProgress = false;
+    // Hidden objects are drawn depth-tested only, inside their query, against everything drawn above
+    if (perObjectQueries) {
+        auto depthOnlyState = [this]() {
+            m_context->OMSetBlendState(m_noColorWriteState.Get(), nullptr, 0xFFFFFFFF);
+            m_context->OMSetDepthStencilState(m_states->DepthRead(), 0);
+        };
+
+        for (size_t i = 0; i < m_objects.Size(); ++i) {
+            auto& obj = m_objects.queries[i];
+            if (!obj.queryHidden || obj.queryInProgress || obj.nextQueryFrame > m_frameIndex) continue;
+            if (m_queryStats.queriesIssued >= m_queryBudget) {
+                m_queryStats.queriesDeferred++;
+                continue;
+            }
+
+            OcclusionQueryHandle query = m_pendingQueries.Begin(static_cast<int>(i), m_frameIndex);
+            if (query == INVALID_OCCLUSION_QUERY) continue;
+            m_cube->Draw(m_objects.GetWorldMatrix(i), view, projection, Colors::White, nullptr, false, depthOnlyState);
+            m_pendingQueries.End(query);
+            obj.queryInProgress = true;
+            m_queryStats.queriesIssued++;
+            m_queryStats.hiddenRetests++;
         }
     }
 
+    // Scheduled queries test proxies against the depth of everything drawn above
+    if (!perObjectQueries && m_queryScheduler) {
+        m_queryScheduler->IssueQueries(view, projection);
+    }
+
     // Present
     m_swapChain->Present(1, 0);
 }
@@ -78,6 +125,7 @@ void DXGame::OnResize(int width, int height) {
 
     m_width = width;
     m_height = height;
+    m_sceneGeneration++;    // Projected pixel sizes change with the viewport
 
     // Release old views
     m_renderTargetView.Reset();
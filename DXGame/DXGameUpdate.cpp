@@ -1,22 +1,35 @@
 #include "DXGame.h"
+#include <cassert>
 
 // ============================================================================
 // UPDATE METHODS
 // ============================================================================
 
 void DXGame::Update() {
+    BeginFrameAllocations();
+
     // Calculate delta time
     auto currentTime = std::chrono::high_resolution_clock::now();
     m_deltaTime = std::chrono::duration<float>(currentTime - m_lastTime).count();
     m_lastTime = currentTime;
+    m_frameIndex++;
+
+    // CPU-only setups choose between BVH and linear culling per frame
+    if (!m_useGPUBVH) {
+        m_cullingMethod = m_cullingSelector.SelectMethod();
+    }
 
     UpdateInput();
     UpdateCamera();
+    UpdateSpawnChurn();
     UpdateDynamicObjects();  // Update object animations
     UpdateSceneBounds();     // Update scene bounds for dynamic objects
     UpdateFrustum();
     UpdateBVH();
     UpdateCulling();
+    CompactCPUBVHWhenIdle();
+    ReorderObjectStorage();
+    LogCullingStats();
 }
 
 void DXGame::UpdateInput() {
@@ -39,6 +52,82 @@ void DXGame::UpdateInput() {
             ShowCursor(TRUE);
         }
     }
+
+    // Toggle bounding-sphere pre-test for CPU culling (A/B timing in the debug output)
+    if (m_keyTracker.IsKeyPressed(DirectX::Keyboard::F2) && m_cpuBVH) {
+        m_cpuBVH->SetUseBoundingSpheres(!m_cpuBVH->IsUsingBoundingSpheres());
+    }
+
+    // Toggle exact SAT test for large nodes
+    if (m_keyTracker.IsKeyPressed(DirectX::Keyboard::F3) && m_cpuBVH) {
+        m_cpuBVH->SetUseExactTest(!m_cpuBVH->IsUsingExactTest());
+        m_sceneGeneration++;
+    }
+
+    // Cycle same-frame software occlusion: off -> per object -> two-phase -> HiZ in BVH traversal
+    if (m_keyTracker.IsKeyPressed(DirectX::Keyboard::F4)) {
+        switch (m_occlusionMode) {
+            case OcclusionMode::None:         m_occlusionMode = OcclusionMode::PerObject; break;
+            case OcclusionMode::PerObject:    m_occlusionMode = OcclusionMode::TwoPhase; break;
+            case OcclusionMode::TwoPhase:     m_occlusionMode = OcclusionMode::HiZTraversal; break;
+            case OcclusionMode::HiZTraversal: m_occlusionMode = OcclusionMode::None; break;
+        }
+        if (m_softwareOcclusion) {
+            m_softwareOcclusion->ResetVisibilityHistory();
+        }
+        m_sceneGeneration++;
+    }
+
+    // Per-object query budget
+    if (m_keyTracker.IsKeyPressed(DirectX::Keyboard::OemCloseBrackets)) {
+        m_queryBudget = std::min(m_queryBudget * 2, Config::MAX_OCCLUSION_QUERY_BUDGET);
+    }
+    if (m_keyTracker.IsKeyPressed(DirectX::Keyboard::OemOpenBrackets) && m_queryBudget > 1) {
+        m_queryBudget /= 2;
+    }
+
+    // Toggle the baked potentially visible set pre-filter
+    if (m_keyTracker.IsKeyPressed(DirectX::Keyboard::F6)) {
+        m_usePVS = !m_usePVS;
+        m_sceneGeneration++;
+    }
+
+    // Toggle cell-and-portal culling
+    if (m_keyTracker.IsKeyPressed(DirectX::Keyboard::F7)) {
+        m_usePortals = !m_usePortals;
+        m_sceneGeneration++;
+    }
+
+    // Toggle the spawn/despawn stress test; switching it off despawns everything it spawned
+    if (m_keyTracker.IsKeyPressed(DirectX::Keyboard::F8)) {
+        m_spawnChurn = !m_spawnChurn;
+        if (!m_spawnChurn) {
+            for (ObjectHandle handle : m_spawnedObjects) {
+                DespawnObject(handle);
+            }
+            m_spawnedObjects.clear();
+        }
+    }
+
+    // Toggle 16-bit quantized bounds for linear culling
+    if (m_keyTracker.IsKeyPressed(DirectX::Keyboard::F9) && m_linearCuller) {
+        m_linearCuller->SetUseQuantizedBounds(!m_linearCuller->IsUsingQuantizedBounds());
+        m_sceneGeneration++;
+    }
+
+    // Toggle periodic reordering of object storage into traversal order
+    if (m_keyTracker.IsKeyPressed(DirectX::Keyboard::F11)) {
+        m_reorderObjects = !m_reorderObjects;
+    }
+
+    // Cycle hardware query scheduling: per object -> hierarchical -> hierarchical on the CPU depth buffer
+    if (m_keyTracker.IsKeyPressed(DirectX::Keyboard::F5)) {
+        switch (m_queryMode) {
+            case QuerySchedulingMode::PerObject:            SetQueryMode(QuerySchedulingMode::Hierarchical); break;
+            case QuerySchedulingMode::Hierarchical:         SetQueryMode(QuerySchedulingMode::HierarchicalSoftware); break;
+            case QuerySchedulingMode::HierarchicalSoftware: SetQueryMode(QuerySchedulingMode::PerObject); break;
+        }
+    }
 }
 
 void DXGame::UpdateCamera() {
@@ -79,7 +168,15 @@ void DXGame::UpdateCamera() {
 void DXGame::UpdateFrustum() {
     Matrix view = m_camera.GetViewMatrix();
     Matrix projection = m_camera.GetProjectionMatrix(static_cast<float>(m_width) / m_height);
-    m_frustum.ExtractFromMatrix(view * projection);
+    m_viewProjection = view * projection;
+    m_frustum.ExtractFromMatrix(m_viewProjection);
+
+    // Projected-size culling uses the same projection and the current viewport height
+    m_screenSizeParams.cameraPosition = m_camera.position;
+    m_screenSizeParams.cameraForward = m_camera.forward;
+    m_screenSizeParams.pixelsPerUnit = static_cast<float>(m_height) / (2.0f * tanf(m_camera.fieldOfView * 0.5f));
+    m_screenSizeParams.minPixelSize = m_minPixelSize;
+    m_screenSizeParams.nearPlane = m_camera.nearPlane;
 }
 
 void DXGame::UpdateBVH() {
@@ -87,7 +184,8 @@ void DXGame::UpdateBVH() {
     bool needsRebuild = m_bvhNeedsRebuild;
     
     if (m_useGPUBVH && m_gpuBVH && !needsRebuild) {
-        needsRebuild = m_gpuBVH->ShouldRebuildBVH(m_objects);
+        // Spawns and despawns re-emit the linear BVH, batched per interval
+        needsRebuild = m_gpuBVH->NeedsRebuild() || m_gpuBVH->ShouldRebuildBVH(m_objects);
     }
     
     if (needsRebuild) {
@@ -95,46 +193,153 @@ void DXGame::UpdateBVH() {
         if (m_useGPUBVH && m_gpuBVH) {
             if (m_gpuBVH->BuildBVH(m_objects, m_sceneMinBounds, m_sceneMaxBounds)) {
                 OutputDebugStringA("GPU BVH rebuilt successfully\n");
+                // The CPU fallback takes over the fresh tree instead of building its own
+                int rootNode = -1;
+                if (m_cpuBVH && (m_cpuBVHStale || !m_cpuBVH->IsValid()) &&
+                    m_gpuBVH->ReadbackNodes(m_bvhReadback, rootNode)) {
+                    m_cpuBVH->AdoptTree(m_bvhReadback, rootNode, m_objects);
+                    m_cpuBVHStale = false;
+                }
             } else {
                 OutputDebugStringA("GPU BVH rebuild failed, falling back to CPU\n");
                 if (m_cpuBVH) {
                     m_cpuBVH->BuildBVH(m_objects);
+                    // Same node layout, so GPU refits keep working on the CPU-built tree
+                    m_gpuBVH->UploadNodes(m_cpuBVH->GetNodes(), m_cpuBVH->GetRootNode());
                 }
             }
-        } else if (m_cpuBVH) {
-            m_cpuBVH->BuildBVH(m_objects);
+        } else {
+            UpdateCPUBVH(true);
         }
         
         m_bvhNeedsRebuild = false;
     } else {
         // Check if any dynamic objects have moved enough to warrant a refit
         bool hasSignificantMovement = false;
-        for (const auto& obj : m_objects) {
-            if (obj.isDynamic && obj.movementDistance > Config::MOVEMENT_THRESHOLD) {
+        for (size_t i = 0; i < m_objects.Size(); ++i) {
+            if (m_objects.dynamic[i] && m_objects.motion[i].movementDistance > Config::MOVEMENT_THRESHOLD) {
                 hasSignificantMovement = true;
                 break;
             }
         }
         
-        if (hasSignificantMovement) {
+        if (m_useGPUBVH && m_gpuBVH) {
             // Perform efficient BVH refit
-            if (m_useGPUBVH && m_gpuBVH) {
-                if (!m_gpuBVH->RefitBVH(m_objects)) {
-                    OutputDebugStringA("GPU BVH refit failed\n");
-                    // Don't fallback to CPU refit as it's expensive
-                    // Mark for rebuild next frame instead
-                    m_bvhNeedsRebuild = true;
-                }
-            } else if (m_cpuBVH) {
-                // CPU BVH doesn't have refit, so rebuild
-                m_cpuBVH->BuildBVH(m_objects);
+            if (hasSignificantMovement && !m_gpuBVH->RefitBVH(m_objects)) {
+                OutputDebugStringA("GPU BVH refit failed\n");
+                // Don't fallback to CPU refit as it's expensive
+                // Mark for rebuild next frame instead
+                m_bvhNeedsRebuild = true;
             }
+        } else {
+            // CPU BVH doesn't have refit, so rebuild
+            UpdateCPUBVH(hasSignificantMovement);
         }
     }
 }
 
+void DXGame::CompactCPUBVHWhenIdle() {
+    // Spawns and despawns scatter the tree; once a frame passes without any, it is laid out again
+    if (!m_cpuBVH || m_cpuBVHStale || !m_cpuBVH->NeedsCompaction()) return;
+    if (m_objects.GetLayoutVersion() != m_frameStartLayout) return;
+
+    m_cpuBVH->Compact();
+    m_frameMaintenance = true;
+}
+
+void DXGame::ReorderObjectStorage() {
+    // Spawns append in creation order; without any since the last pass there is nothing to gain
+    if (!m_reorderObjects || m_frameIndex - m_lastReorderFrame < Config::OBJECT_REORDER_INTERVAL) return;
+    if (m_objects.GetLayoutVersion() == m_reorderedLayout || m_objects.Size() < 2) return;
+    auto startTime = std::chrono::high_resolution_clock::now();
+    m_lastReorderFrame = m_frameIndex;
+
+    // The CPU BVH's leaf order is the order its traversal reads objects in. Without a
+    // current tree, or for objects it does not hold, a Morton curve is the next best thing.
+    bool fromLeafOrder = m_cpuBVH && m_cpuBVH->IsValid() && !m_cpuBVHStale;
+    if (fromLeafOrder) {
+        m_cpuBVH->GetLeafOrder(m_reorderOrder);
+        fromLeafOrder = m_reorderOrder.size() == m_objects.Size();
+    }
+    if (!fromLeafOrder) {
+        m_objects.GetMortonOrder(m_reorderOrder);
+    }
+
+    m_objects.Reorder(m_reorderOrder, m_reorder);
+
+    // Every index-keyed structure relabels, as it replays a swap-remove
+    if (m_cpuBVH) {
+        if (m_cpuBVH->IsValid() && !m_cpuBVHStale) {
+            m_cpuBVH->RemapObjects(m_reorder);
+        } else {
+            m_cpuBVHStale = true;
+        }
+    }
+    if (m_useGPUBVH && m_gpuBVH) {
+        m_gpuBVH->RemapObjects(m_reorder);
+    }
+    m_portalSystem.RemapObjects(m_reorder);
+    m_pendingQueries.RemapObjects(m_reorder);
+    if (m_queryScheduler) {
+        m_queryScheduler->RemapObjects(m_reorder);
+    }
+    if (m_softwareOcclusion) {
+        m_softwareOcclusion->RemapObjects(m_reorder);
+    }
+    m_reorderedLayout = m_objects.GetLayoutVersion();
+    m_sceneGeneration++;
+    m_frameMaintenance = true;
+
+    m_reorderStats.reorders++;
+    m_reorderStats.fromLeafOrder += fromLeafOrder ? 1 : 0;
+    for (size_t i = 0; i < m_reorder.newIndex.size(); i++) {
+        m_reorderStats.objectsMoved += m_reorder.newIndex[i] != static_cast<int>(i) ? 1 : 0;
+    }
+    m_reorderStats.timeMs += std::chrono::duration<float, std::milli>(
+        std::chrono::high_resolution_clock::now() - startTime).count();
+}
+
+void DXGame::UpdateCPUBVH(bool rebuildNeeded) {
+    if (!m_cpuBVH) return;
+
+    if (m_cullingMethod == CullingMethod::Linear) {
+        // Linear culling reads bounds directly - defer tree upkeep until the BVH is used again
+        m_cpuBVHStale = m_cpuBVHStale || rebuildNeeded;
+    } else if (rebuildNeeded || m_cpuBVHStale || !m_cpuBVH->IsValid()) {
+        auto startTime = std::chrono::high_resolution_clock::now();
+        m_cpuBVH->BuildBVH(m_objects);
+        m_cullingSelector.RecordRebuildCost(std::chrono::duration<float, std::milli>(
+            std::chrono::high_resolution_clock::now() - startTime).count());
+        m_cpuBVHStale = false;
+    }
+
+    // Steady-state upkeep is charged to the BVH even while it is deferred
+    m_cullingSelector.RecordMaintenanceDemand(rebuildNeeded);
+}
+
 void DXGame::UpdateCulling() {
-    PerformCulling();
+    // The same view over an unchanged scene keeps last frame's results
+    if (m_visibilityCache.RestoreUnchanged(m_viewProjection, m_sceneGeneration, m_objects)) {
+        ProcessOcclusionQueries();
+        return;
+    }
+
+    // After a small camera move only objects near the frustum boundary are re-tested
+    UpdatePotentiallyVisibleSet();
+    bool refined = m_visibilityCache.RefineFrustumResults(m_frustum, m_sceneGeneration, m_pvsCell,
+        m_pvsMask.Empty() ? nullptr : &m_pvsMask, m_screenSizeParams, m_objects);
+    if (refined) {
+        m_portalCullingDone = false;
+        m_occlusionDoneInTraversal = false;
+    } else {
+        PerformCulling();
+        // Portal rectangles and HiZ tests are not captured by the frustum band
+        m_visibilityCache.StoreFrustumResults(m_frustum, m_sceneMinBounds, m_sceneMaxBounds, m_sceneGeneration,
+            m_pvsCell, m_screenSizeParams, !m_portalCullingDone && !m_occlusionDoneInTraversal, m_objects);
+    }
+
+    PerformSoftwareOcclusion();
+    m_visibilityCache.StoreFinalResults(m_viewProjection, m_sceneGeneration, m_objects);
     ProcessOcclusionQueries();
 }
 
@@ -144,31 +349,169 @@ void DXGame::UpdateDynamicObjects() {
         m_gpuBVH->UpdateDynamicObjects(m_objects, m_deltaTime);
     } else {
         // Fallback: update dynamic objects manually
-        for (auto& obj : m_objects) {
-            if (obj.isDynamic) {
+        m_movedObjects.clear();
+        for (size_t i = 0; i < m_objects.Size(); ++i) {
+            if (m_objects.dynamic[i]) {
+                ObjectMotion& motion = m_objects.motion[i];
+
                 // Update animation time
-                obj.animationTime += m_deltaTime;
+                motion.animationTime += m_deltaTime;
                 
                 // Calculate new position based on circular motion
-                Vector3 newPosition = obj.animationCenter + Vector3(
-                    cos(obj.animationTime) * obj.animationRadius,
+                Vector3 newPosition = motion.animationCenter + Vector3(
+                    cos(motion.animationTime) * motion.animationRadius,
                     0.0f,
-                    sin(obj.animationTime) * obj.animationRadius
+                    sin(motion.animationTime) * motion.animationRadius
                 );
                 
                 // Calculate movement distance
-                Vector3 currentPos = obj.GetPosition();
-                obj.movementDistance = (newPosition - currentPos).Length();
-                obj.previousPosition = currentPos;
-                
-                // Update world matrix
-                obj.world = Matrix::CreateTranslation(newPosition);
+                Vector3 currentPos = m_objects.GetPosition(i);
+                motion.movementDistance = (newPosition - currentPos).Length();
+                motion.previousPosition = currentPos;
                 
-                // Update bounding box
-                obj.UpdateBounds();
+                // Update position
+                m_objects.transforms[i].position = newPosition;
+                m_movedObjects.push_back(static_cast<uint32_t>(i));
             }
         }
+        
+        // Update bounding boxes
+        m_objects.UpdateBounds(m_movedObjects.data(), m_movedObjects.size());
+    }
+}
+
+// ============================================================================
+// FRAME MEMORY
+// ============================================================================
+
+void DXGame::BeginFrameAllocations() {
+    // The last frame's update and render are done, so nothing it took from the arena is alive
+    bool arenaOverflowed = m_frameArena.HasOverflowed();
+    m_frameArena.Reset();
+
+    uint64_t heapAllocations = GetHeapAllocationCount();
+    int frameAllocations = static_cast<int>(heapAllocations - m_frameStartHeapAllocations);
+    m_frameMemoryStats.frames++;
+    m_frameMemoryStats.heapAllocations += frameAllocations;
+
+    size_t queryCapacity = m_pendingQueries.GetCapacity() + (m_d3dQueryBackend ? m_d3dQueryBackend->GetPoolSize() : 0);
+
+    // Spawns, toggles, resizes, method switches, arena growth and more queries in flight
+    // than ever before may allocate; nothing else should
+    bool steady = m_frameIndex > Config::FRAME_ALLOCATION_WARMUP_FRAMES && !arenaOverflowed &&
+        m_frameStartLayout == m_objects.GetLayoutVersion() && m_frameStartGeneration == m_sceneGeneration &&
+        m_frameStartCullingMethod == m_cullingMethod && m_frameStartQueryMode == m_queryMode &&
+        m_frameStartQueryCapacity == queryCapacity && !m_frameMaintenance;
+    if (steady && frameAllocations > 0) {
+        m_frameMemoryStats.steadyFramesAllocating++;
+        char buffer[128];
+        snprintf(buffer, sizeof(buffer), "Frame %d made %d heap allocations in steady state\n",
+            m_frameIndex, frameAllocations);
+        OutputDebugStringA(buffer);
+        assert(!"Per-frame temporaries belong in the frame arena");
     }
+
+    m_frameStartHeapAllocations = GetHeapAllocationCount();
+    m_frameStartLayout = m_objects.GetLayoutVersion();
+    m_frameStartGeneration = m_sceneGeneration;
+    m_frameStartCullingMethod = m_cullingMethod;
+    m_frameStartQueryMode = m_queryMode;
+    m_frameStartQueryCapacity = queryCapacity;
+    m_frameMaintenance = false;
+}
+
+// ============================================================================
+// OBJECT LIFETIME
+// ============================================================================
+
+ObjectHandle DXGame::SpawnObject(const RenderObject& object) {
+    ObjectHandle handle = m_objects.Add(object);
+    int index = static_cast<int>(m_objects.Size() - 1);
+
+    // Trees link the new leaf in place; one already due for a rebuild just stays due
+    if (m_cpuBVH) {
+        if (m_cpuBVH->IsValid() && !m_cpuBVHStale) {
+            m_cpuBVH->InsertObject(m_objects, index);
+        } else {
+            m_cpuBVHStale = true;
+        }
+    }
+    if (m_useGPUBVH && m_gpuBVH) {
+        m_gpuBVH->InsertObject(m_objects, index);
+    }
+    m_portalSystem.InsertObject(m_objects, index);
+    if (m_queryScheduler) {
+        m_queryScheduler->InsertObject(m_objects, index);
+    }
+
+    m_sceneGeneration++;
+    m_lifetimeStats.spawned++;
+    return handle;
+}
+
+bool DXGame::DespawnObject(ObjectHandle handle) {
+    int index = m_objects.IndexOf(handle);
+    if (index < 0) return false;
+
+    // The bake counted on this object hiding others
+    if (m_pvs.IsBakedObject(handle) && !m_objects.dynamic[index]) {
+        m_pvs.Clear();
+        OutputDebugStringA("PVS dropped: a baked static object was despawned\n");
+    }
+
+    ObjectRemoval removal;
+    m_objects.Remove(handle, removal);
+
+    // Every index-keyed structure replays the swap-remove
+    if (m_cpuBVH) {
+        if (m_cpuBVH->IsValid() && !m_cpuBVHStale) {
+            m_cpuBVH->RemoveObject(removal);
+        } else {
+            m_cpuBVHStale = true;
+        }
+    }
+    if (m_useGPUBVH && m_gpuBVH) {
+        m_gpuBVH->RemoveObject(removal);
+    }
+    m_portalSystem.RemoveObject(removal);
+    m_pendingQueries.RemoveObject(removal);
+    if (m_queryScheduler) {
+        m_queryScheduler->RemoveObject(removal);
+    }
+    if (m_softwareOcclusion) {
+        m_softwareOcclusion->RemoveObject(removal);
+    }
+
+    m_sceneGeneration++;
+    m_lifetimeStats.despawned++;
+    return true;
+}
+
+void DXGame::UpdateSpawnChurn() {
+    if (!m_spawnChurn) return;
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    // Small cubes scattered over a field beyond the test cubes at random orientations, oldest despawned first
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    const float area = Config::SPAWN_CHURN_AREA;
+    for (int i = 0; i < Config::SPAWN_CHURN_PER_FRAME; i++) {
+        if (static_cast<int>(m_spawnedObjects.size()) >= Config::SPAWN_CHURN_POPULATION) {
+            DespawnObject(m_spawnedObjects.front());
+            m_spawnedObjects.pop_front();
+        }
+
+        Vector3 position((unit(m_spawnRandom) - 0.5f) * area, unit(m_spawnRandom) * 6.0f - 3.0f,
+                         20.0f + unit(m_spawnRandom) * area);
+        RenderObject obj;
+        obj.position = position;
+        obj.scale = Vector3(0.5f, 0.5f, 0.5f);
+        obj.rotation = Quaternion::CreateFromYawPitchRoll(unit(m_spawnRandom) * XM_2PI, unit(m_spawnRandom) * XM_2PI,
+                                                          unit(m_spawnRandom) * XM_2PI);
+        m_spawnedObjects.push_back(SpawnObject(obj));
+    }
+
+    m_lifetimeStats.timeMs += std::chrono::duration<float, std::milli>(
+        std::chrono::high_resolution_clock::now() - startTime).count();
 }
 
 // ============================================================================
@@ -177,41 +520,467 @@ void DXGame::UpdateDynamicObjects() {
 
 void DXGame::PerformCulling() {
     bool gpuCullingSuccess = false;
+    m_occlusionDoneInTraversal = false;
+    m_pvsDoneInTraversal = false;
+    UpdatePotentiallyVisibleSet();
+
+    // Inside the cell graph only what the doorways let through is culled
+    m_portalCullingDone = false;
+    if (m_usePortals && m_portalSystem.IsValid()) {
+        m_portalSystem.SetScreenSizeCulling(m_screenSizeParams);
+        m_portalCullingDone = m_portalSystem.PerformCulling(m_viewProjection, m_camera.position, m_objects);
+    }
 
     // Try GPU culling first
-    if (m_useGPUBVH && m_gpuBVH) {
+    if (!m_portalCullingDone && m_useGPUBVH && m_gpuBVH) {
+        m_gpuBVH->SetScreenSizeCulling(m_screenSizeParams);
         gpuCullingSuccess = m_gpuBVH->PerformFrustumCulling(m_frustum, m_objects);
     }
 
     // Fallback to CPU culling if GPU failed
-    if (!gpuCullingSuccess && m_cpuBVH) {
+    if (!m_portalCullingDone && !gpuCullingSuccess) {
+        PerformCPUCulling();
+    }
+
+    // Only the CPU BVH takes the set as a pre-filter; the other paths drop non-candidates afterwards
+    if (!m_pvsDoneInTraversal) {
+        ApplyPotentiallyVisibleSet();
+    }
+}
+
+void DXGame::UpdatePotentiallyVisibleSet() {
+    int cell = m_usePVS ? m_pvs.FindCell(m_camera.position) : -1;
+    if (cell == m_pvsCell && m_pvsMaskLayout == m_objects.GetLayoutVersion()) return;
+    m_pvsCell = cell;
+    m_pvsMaskLayout = m_objects.GetLayoutVersion();
+
+    // The mask only changes when the camera crosses into another cell, or objects come and go
+    if (cell < 0 || !m_pvs.DecodeCell(cell, m_objects, m_pvsMask)) {
+        m_pvsMask.Clear();
+    }
+    m_pvsCandidates = static_cast<int>(m_pvsMask.Count());
+
+    if (m_cpuBVH) {
+        m_cpuBVH->SetCandidateMask(m_pvsMask.Empty() ? nullptr : &m_pvsMask);
+    }
+}
+
+void DXGame::ApplyPotentiallyVisibleSet() {
+    if (m_pvsMask.Size() != m_objects.Size()) return;
+
+    m_objects.visible.And(m_pvsMask);
+}
+
+void DXGame::PerformCPUCulling() {
+    bool useLinear = m_cullingMethod == CullingMethod::Linear && m_linearCuller;
+
+    // Occluder rasterization is not a culling-method cost, so it stays outside the timing
+    m_occlusionDoneInTraversal = !useLinear && m_cpuBVH && PrepareOcclusionPyramid();
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    if (useLinear) {
+        m_linearCuller->SetScreenSizeCulling(m_screenSizeParams);
+        m_linearCuller->PerformFrustumCulling(m_frustum, m_objects);
+    } else if (m_cpuBVH) {
+        m_pvsDoneInTraversal = true;
+        m_cpuBVH->SetOcclusionPyramid(m_occlusionDoneInTraversal ? &m_hizPyramid : nullptr);
+        m_cpuBVH->SetScreenSizeCulling(m_screenSizeParams);
         m_cpuBVH->PerformFrustumCulling(m_frustum, m_objects);
+    } else {
+        return;
+    }
+
+    // Only a CPU-only setup picks its method adaptively
+    if (!m_useGPUBVH) {
+        m_cullingSelector.RecordCullingCost(m_cullingMethod, std::chrono::duration<float, std::milli>(
+            std::chrono::high_resolution_clock::now() - startTime).count());
     }
 }
 
+bool DXGame::PrepareOcclusionPyramid() {
+    if (m_occlusionMode != OcclusionMode::HiZTraversal || !m_softwareOcclusion) return false;
+
+    // Traversal has not run yet, so occluders are picked by the frustum directly
+    m_softwareOcclusion->RenderOccluders(m_viewProjection, m_camera.position, m_objects, &m_frustum);
+    m_hizPyramid.Build(m_softwareOcclusion->GetDepthBuffer(), m_softwareOcclusion->GetWidth(),
+                       m_softwareOcclusion->GetHeight(), m_viewProjection);
+    return m_hizPyramid.IsValid();
+}
+
+void DXGame::PerformSoftwareOcclusion() {
+    // GPU and linear culling cannot use the pyramid, so HiZ mode falls back to per-object tests
+    if (m_occlusionMode == OcclusionMode::None || m_occlusionDoneInTraversal || !m_softwareOcclusion) return;
+
+    // Runs on the frustum-culled set, so hidden objects are dropped before this frame's draw
+    if (m_occlusionMode == OcclusionMode::TwoPhase) {
+        m_softwareOcclusion->PerformTwoPhaseCulling(m_viewProjection, m_camera.position, m_objects);
+    } else {
+        m_softwareOcclusion->PerformOcclusionCulling(m_viewProjection, m_camera.position, m_objects);
+    }
+}
+
+void DXGame::SetQueryMode(QuerySchedulingMode mode) {
+    if (!m_queryScheduler) return;
+
+    // Without a hardware backend the hierarchical mode runs on the software one
+    if (mode == QuerySchedulingMode::Hierarchical && !m_d3dQueryBackend) {
+        mode = QuerySchedulingMode::HierarchicalSoftware;
+    }
+    m_queryMode = mode;
+
+    // Per-object results still in flight belong to the mode being left; their queries go back to the pool
+    if (mode != QuerySchedulingMode::PerObject) {
+        m_pendingQueries.Clear();
+        for (auto& query : m_objects.queries) {
+            query.queryInProgress = false;
+            query.queryHidden = false;
+        }
+    }
+
+    switch (mode) {
+        case QuerySchedulingMode::PerObject:            m_queryScheduler->SetBackend(nullptr); break;
+        case QuerySchedulingMode::Hierarchical:         m_queryScheduler->SetBackend(m_d3dQueryBackend.get()); break;
+        case QuerySchedulingMode::HierarchicalSoftware: m_queryScheduler->SetBackend(m_softwareQueryBackend.get()); break;
+    }
+}
+
+void DXGame::ScheduleHierarchicalQueries() {
+    if (!m_queryScheduler) return;
+
+    // The software backend reads the CPU depth buffer, which only occlusion culling fills
+    if (m_queryMode == QuerySchedulingMode::HierarchicalSoftware && m_occlusionMode == OcclusionMode::None &&
+        m_softwareOcclusion) {
+        m_softwareOcclusion->RenderOccluders(m_viewProjection, m_camera.position, m_objects);
+    }
+
+    m_queryScheduler->Update(m_frustum, m_camera.position, m_camera.nearPlane, m_objects);
+}
+
 void DXGame::ProcessOcclusionQueries() {
-    for (auto& obj : m_objects) {
-        if (obj.occlusionQuery && obj.queryInProgress) {
-            UINT64 result = 0;
-            HRESULT hr = m_context->GetData(obj.occlusionQuery.Get(), &result, sizeof(result), D3D11_ASYNC_GETDATA_DONOTFLUSH);
-
-            if (hr == S_OK) {
-                obj.lastQueryResult = result;
-                obj.queryInProgress = false;
-
-                if (result == 0) {
-                    // Object is occluded
-                    obj.occludedFrameCount++;
-                    // Hide object after being occluded for threshold frames
-                    if (obj.occludedFrameCount >= Config::OCCLUSION_FRAME_THRESHOLD && obj.visible) {
-                        obj.visible = false;
-                    }
-                } else {
-                    // Object is visible - reset counter
-                    obj.occludedFrameCount = 0;
-                }
+    if (m_queryMode != QuerySchedulingMode::PerObject) {
+        ScheduleHierarchicalQueries();
+        return;
+    }
+
+    auto startTime = std::chrono::high_resolution_clock::now();
+    // Issued, re-test and deferred counts come from Render and are logged a frame late
+    m_queryStats.resultsReceived = 0;
+    m_queryStats.objectsHidden = 0;
+    m_queryStats.objectsInView = 0;
+    UpdateQueryIntervals();
+
+    // Results come back in issue order: read from the oldest query and stop at the first not ready
+    m_pendingQueries.ResetPollCount();
+    int objectIndex = -1;
+    UINT64 result = 0;
+    while (m_pendingQueries.PopReady(objectIndex, result)) {
+        if (objectIndex < 0 || objectIndex >= static_cast<int>(m_objects.Size())) continue;
+
+        auto& obj = m_objects.queries[objectIndex];
+        obj.lastQueryResult = result;
+        obj.queryInProgress = false;
+        m_queryStats.resultsReceived++;
+
+        bool wasOccluded = obj.occludedFrameCount > 0;
+        if (result == 0) {
+            // Object is occluded
+            obj.occludedFrameCount++;
+        } else {
+            // Object is visible - reset counter
+            obj.occludedFrameCount = 0;
+        }
+
+        // Visible twice in a row doubles the wait before the next query, anything else starts over.
+        // Hidden objects are re-tested every frame as in CHC++, so one coming out from behind an
+        // occluder is missing for a frame, not an interval. Staggered by index so objects answered
+        // together are not all due together again.
+        bool stayedVisible = result != 0 && !wasOccluded;
+        obj.queryInterval = stayedVisible ? std::min(obj.queryInterval * 2, Config::MAX_QUERY_INTERVAL) : 1;
+        obj.nextQueryFrame = m_frameIndex + obj.queryInterval - (objectIndex % (obj.queryInterval / 2 + 1));
+    }
+    m_queryStats.queriesPolled = m_pendingQueries.GetPollCount();
+    m_queryStats.queriesInFlight = static_cast<int>(m_pendingQueries.GetPendingCount());
+    m_queryStats.oldestQueryAge = m_queryStats.queriesInFlight > 0 ?
+        m_frameIndex - m_pendingQueries.GetOldestIssueFrame() : 0;
+    m_queryStats.queryPoolSize = m_d3dQueryBackend ? m_d3dQueryBackend->GetPoolSize() : 0;
+
+    int intervalSum = 0;
+    for (size_t i = 0; i < m_objects.Size(); ++i) {
+        auto& obj = m_objects.queries[i];
+
+        // Objects in view stay hidden until a re-test says otherwise
+        bool inView = m_objects.visible.Test(i);
+        obj.queryHidden = inView && obj.occludedFrameCount >= Config::OCCLUSION_FRAME_THRESHOLD;
+        if (obj.queryHidden) {
+            m_objects.visible.Reset(i);
+            m_queryStats.objectsHidden++;
+        }
+
+        if (inView) {
+            m_queryStats.objectsInView++;
+            intervalSum += obj.queryInterval;
+        } else {
+            // History from before an object left the view says nothing once it is back
+            obj.occludedFrameCount = 0;
+            obj.queryInterval = 1;
+            obj.nextQueryFrame = 0;
+        }
+    }
+
+    m_queryStats.averageInterval = m_queryStats.objectsInView > 0 ?
+        static_cast<float>(intervalSum) / m_queryStats.objectsInView : 0.0f;
+    m_queryStats.pollTimeMs = std::chrono::duration<float, std::milli>(
+        std::chrono::high_resolution_clock::now() - startTime).count();
+}
+
+void DXGame::UpdateQueryIntervals() {
+    // Fast camera motion makes every stable answer suspect - query everything in view again
+    float deltaTime = std::max(m_deltaTime, 1e-4f);
+    float speed = (m_camera.position - m_lastQueryCameraPosition).Length() / deltaTime;
+    float turnRate = acosf(std::min(std::max(m_camera.forward.Dot(m_lastQueryCameraForward), -1.0f), 1.0f)) / deltaTime;
+    m_lastQueryCameraPosition = m_camera.position;
+    m_lastQueryCameraForward = m_camera.forward;
+
+    m_queryStats.intervalsReset = speed > Config::QUERY_RESET_CAMERA_SPEED || turnRate > Config::QUERY_RESET_CAMERA_TURN;
+    m_queryStats.intervalsResetNearMovers = 0;
+    if (m_queryStats.intervalsReset) {
+        for (auto& query : m_objects.queries) {
+            query.queryInterval = 1;
+            query.nextQueryFrame = m_frameIndex;
+        }
+        return;
+    }
+
+    // Anything moving in view hides what is now behind it and uncovers what it hid, so stable
+    // answers on screen near it are stale. The box is pushed out by the distance moved so it
+    // also covers where the object was last frame.
+    float width = static_cast<float>(m_width);
+    float height = static_cast<float>(m_height);
+    ArenaAllocator<ScreenBounds> arenaAllocator(&m_frameArena);
+    ArenaVector<ScreenBounds> moverBounds(arenaAllocator);
+    bool moverAtNearPlane = false;
+    for (size_t i = 0; i < m_objects.Size(); ++i) {
+        if (!m_objects.HasMoved(i) || !m_objects.visible.Test(i)) continue;
+
+        Vector3 reach = Vector3::One * m_objects.motion[i].movementDistance;
+        ScreenBounds bounds;
+        if (bounds.FromBox(m_viewProjection, width, height, m_objects.bounds[i].minBounds - reach,
+                           m_objects.bounds[i].maxBounds + reach)) {
+            moverBounds.push_back(bounds);
+        } else {
+            moverAtNearPlane = true;    // Could cover any part of the screen
+        }
+    }
+    if (moverBounds.empty() && !moverAtNearPlane) return;
+
+    for (size_t i = 0; i < m_objects.Size(); ++i) {
+        auto& query = m_objects.queries[i];
+        if (query.queryInterval <= 1 || !m_objects.visible.Test(i)) continue;
+
+        ScreenBounds bounds;
+        bool nearMover = moverAtNearPlane ||
+            !bounds.FromBox(m_viewProjection, width, height, m_objects.bounds[i].minBounds, m_objects.bounds[i].maxBounds);
+        for (size_t m = 0; m < moverBounds.size() && !nearMover; m++) {
+            const ScreenBounds& mover = moverBounds[m];
+            nearMover = bounds.minX <= mover.maxX && mover.minX <= bounds.maxX &&
+                        bounds.minY <= mover.maxY && mover.minY <= bounds.maxY;
+        }
+        if (nearMover) {
+            query.queryInterval = 1;
+            query.nextQueryFrame = m_frameIndex;
+            m_queryStats.intervalsResetNearMovers++;
+        }
+    }
+}
+
+void DXGame::LogCullingStats() {
+    if ((m_frameIndex % Config::STATS_LOG_INTERVAL) != 0) return;
+
+    const VisibilityCacheStats& cache = m_visibilityCache.GetStats();
+    char cacheBuffer[200];
+    if (cache.reused) {
+        snprintf(cacheBuffer, sizeof(cacheBuffer), "Visibility cache: view and scene unchanged, last frame reused\n");
+    } else if (cache.refined) {
+        snprintf(cacheBuffer, sizeof(cacheBuffer),
+            "Visibility cache: refined, %d of %d objects re-tested (drift %.2f), %.3f ms\n",
+            cache.objectsRetested, static_cast<int>(m_objects.Size()), cache.drift, cache.timeMs);
+    } else {
+        snprintf(cacheBuffer, sizeof(cacheBuffer), "Visibility cache: full pass, %d objects in the boundary band\n",
+            cache.boundaryObjects);
+    }
+    OutputDebugStringA(cacheBuffer);
+
+    char memoryBuffer[200];
+    snprintf(memoryBuffer, sizeof(memoryBuffer),
+        "Frame memory: arena peak %.1f of %.1f KB (grown %d times), %d heap allocations in %d frames, "
+        "%d steady frames allocating\n",
+        m_frameArena.GetPeakBytes() / 1024.0f, m_frameArena.GetCapacity() / 1024.0f, m_frameArena.GetGrowthCount(),
+        m_frameMemoryStats.heapAllocations, m_frameMemoryStats.frames, m_frameMemoryStats.steadyFramesAllocating);
+    OutputDebugStringA(memoryBuffer);
+    m_frameMemoryStats.Reset();
+
+    if (m_spawnChurn || m_lifetimeStats.spawned > 0 || m_lifetimeStats.despawned > 0) {
+        char lifetimeBuffer[160];
+        snprintf(lifetimeBuffer, sizeof(lifetimeBuffer), "Objects: %d alive, %d spawned and %d despawned since last line, %.3f ms\n",
+            static_cast<int>(m_objects.Size()), m_lifetimeStats.spawned, m_lifetimeStats.despawned, m_lifetimeStats.timeMs);
+        OutputDebugStringA(lifetimeBuffer);
+        m_lifetimeStats.Reset();
+    }
+
+    if (m_reorderStats.reorders > 0) {
+        char reorderBuffer[160];
+        snprintf(reorderBuffer, sizeof(reorderBuffer), "Object reorder: %d passes (%d in BVH leaf order, the rest Morton), "
+            "%d objects moved, %.3f ms\n",
+            m_reorderStats.reorders, m_reorderStats.fromLeafOrder, m_reorderStats.objectsMoved, m_reorderStats.timeMs);
+        OutputDebugStringA(reorderBuffer);
+        m_reorderStats.Reset();
+    }
+
+    if (m_pvs.IsValid()) {
+        char pvsBuffer[160];
+        snprintf(pvsBuffer, sizeof(pvsBuffer), "PVS [%s]: cell %d, %d of %d objects potentially visible\n",
+            m_usePVS ? "on" : "off", m_pvsCell, m_pvsMask.Empty() ? static_cast<int>(m_objects.Size()) : m_pvsCandidates,
+            static_cast<int>(m_objects.Size()));
+        OutputDebugStringA(pvsBuffer);
+    }
+
+    if (m_portalSystem.IsValid()) {
+        const PortalStats& portals = m_portalSystem.GetStats();
+        char portalBuffer[256];
+        if (m_portalCullingDone) {
+            snprintf(portalBuffer, sizeof(portalBuffer),
+                "Portals: cell %d, %d cells visited (depth %d), %d of %d portals passed, %d nodes, %.3f ms\n",
+                portals.cameraCell, portals.cellsVisited, portals.maxDepth, portals.portalsPassed,
+                portals.portalsTested, portals.nodesVisited, portals.cullTimeMs);
+        } else {
+            snprintf(portalBuffer, sizeof(portalBuffer), "Portals [%s]: camera outside the cells, culling the whole scene\n",
+                m_usePortals ? "on" : "off");
+        }
+        OutputDebugStringA(portalBuffer);
+    }
+
+    if (m_occlusionMode != OcclusionMode::None && m_softwareOcclusion) {
+        const OcclusionStats& occlusion = m_softwareOcclusion->GetStats();
+        char occlusionBuffer[320];
+        if (m_occlusionDoneInTraversal) {
+            snprintf(occlusionBuffer, sizeof(occlusionBuffer),
+                "Software occlusion [HiZ]: raster %.3f ms (%d occluders, %d skipped), pyramid %.3f ms (%d levels)\n",
+                occlusion.rasterTimeMs, occlusion.occludersRasterized, occlusion.occludersSkipped,
+                m_hizPyramid.GetBuildTimeMs(), m_hizPyramid.GetLevelCount());
+        } else if (m_occlusionMode == OcclusionMode::TwoPhase) {
+            snprintf(occlusionBuffer, sizeof(occlusionBuffer),
+                "Software occlusion [two-phase]: raster %.3f ms (%d occluders), test %.3f ms, reused %d, newly visible %d, "
+                "occluded %d, leaving the set %d\n",
+                occlusion.rasterTimeMs, occlusion.occludersRasterized, occlusion.testTimeMs, occlusion.reusedVisible,
+                occlusion.newlyVisible, occlusion.objectsOccluded, occlusion.noLongerVisible);
+        } else {
+            snprintf(occlusionBuffer, sizeof(occlusionBuffer),
+                "Software occlusion: raster %.3f ms (%d occluders, %d skipped), test %.3f ms, occluded %d of %d\n",
+                occlusion.rasterTimeMs, occlusion.occludersRasterized, occlusion.occludersSkipped,
+                occlusion.testTimeMs, occlusion.objectsOccluded, occlusion.objectsTested);
+        }
+        OutputDebugStringA(occlusionBuffer);
+
+        // Occluders that own no pixels or hide nothing are wasted budget
+        const OccluderSelector& selector = m_softwareOcclusion->GetOccluderSelector();
+        int idleOccluders = 0;
+        int bestOccluder = -1;
+        int bestPixels = 0;
+        for (const auto& occluder : selector.GetSelection()) {
+            if (occluder.pixelsOwned == 0 || (!m_occlusionDoneInTraversal && occluder.objectsOccluded == 0)) {
+                idleOccluders++;
+            }
+            if (occluder.pixelsOwned > bestPixels) {
+                bestPixels = occluder.pixelsOwned;
+                bestOccluder = occluder.objectIndex;
             }
-            // If hr == S_FALSE, query data not ready yet, keep waiting
         }
+        snprintf(occlusionBuffer, sizeof(occlusionBuffer),
+            "Occluder selection: %d of %d candidates, %d/%d px, %d/%d triangles, %d idle, best object %d (%d px)\n",
+            static_cast<int>(selector.GetSelection().size()), selector.GetCandidateCount(),
+            selector.GetPixelsUsed(), selector.GetPixelBudget(), selector.GetTrianglesUsed(), selector.GetTriangleBudget(),
+            idleOccluders, bestOccluder, bestPixels);
+        OutputDebugStringA(occlusionBuffer);
     }
+
+    if (m_queryMode == QuerySchedulingMode::PerObject) {
+        char queryBuffer[384];
+        snprintf(queryBuffer, sizeof(queryBuffer),
+            "Per-object queries: poll %.3f ms (%d polled, %d results, %d in flight, oldest %d frames, pool %d), "
+            "in view %d, hidden %d, average interval %.1f%s, %d reset near moving objects, "
+            "last frame issued %d (%d hidden re-tests), deferred %d, budget %d\n",
+            m_queryStats.pollTimeMs, m_queryStats.queriesPolled, m_queryStats.resultsReceived,
+            m_queryStats.queriesInFlight, m_queryStats.oldestQueryAge, m_queryStats.queryPoolSize,
+            m_queryStats.objectsInView, m_queryStats.objectsHidden, m_queryStats.averageInterval,
+            m_queryStats.intervalsReset ? " (reset by camera motion)" : "", m_queryStats.intervalsResetNearMovers,
+            m_queryStats.queriesIssued, m_queryStats.hiddenRetests, m_queryStats.queriesDeferred, m_queryBudget);
+        OutputDebugStringA(queryBuffer);
+    } else if (m_queryScheduler) {
+        const QuerySchedulerStats& queries = m_queryScheduler->GetStats();
+        char queryBuffer[384];
+        snprintf(queryBuffer, sizeof(queryBuffer),
+            "Query scheduling [%s]: %.3f ms, nodes %d, invisible %d, objects hidden %d, queries %d (%d multi, %d nodes), "
+            "re-checks skipped %d, results %d, multi-query failures %d, turned visible %d, invisible %d, pending %d\n",
+            m_queryMode == QuerySchedulingMode::Hierarchical ? "D3D" : "software",
+            queries.scheduleTimeMs, queries.nodesVisited, queries.invisibleNodes, queries.objectsHidden,
+            queries.queriesIssued, queries.multiQueries, queries.nodesQueried, queries.visibleQueriesSkipped,
+            queries.resultsReceived, queries.multiQueryFailures, queries.nodesTurnedVisible, queries.nodesTurnedInvisible,
+            queries.pendingQueries);
+        OutputDebugStringA(queryBuffer);
+    }
+
+    // Only the CPU path traverses on the CPU, so only it has meaningful counters
+    if (m_useGPUBVH || !m_cpuBVH) return;
+
+    char selectorBuffer[160];
+    snprintf(selectorBuffer, sizeof(selectorBuffer),
+        "Culling selector: active %s, estimated BVH %.3f ms (incl. upkeep), linear %.3f ms\n",
+        m_cullingSelector.GetActiveMethod() == CullingMethod::Linear ? "linear" : "BVH",
+        m_cullingSelector.GetEstimatedCost(CullingMethod::Hierarchical),
+        m_cullingSelector.GetEstimatedCost(CullingMethod::Linear));
+    OutputDebugStringA(selectorBuffer);
+
+    if (m_linearCuller && m_linearCuller->IsUsingQuantizedBounds()) {
+        const QuantizedBoundsStats& quantized = m_linearCuller->GetQuantizedStats();
+        if (quantized.culls > 0) {
+            char quantizedBuffer[256];
+            snprintf(quantizedBuffer, sizeof(quantizedBuffer),
+                "Quantized bounds: %d linear culls, %.1f KB streamed per cull against %.1f KB as floats (%.0f%% saved), "
+                "%d blocks re-encoded, extra false positives %d of %d sampled (%.3f%%)\n",
+                quantized.culls, quantized.boundsBytes / 1024.0 / quantized.culls,
+                quantized.floatBoundsBytes / 1024.0 / quantized.culls,
+                100.0 * (1.0 - static_cast<double>(quantized.boundsBytes) / quantized.floatBoundsBytes),
+                quantized.blocksEncoded, quantized.falsePositives, quantized.objectsSampled,
+                quantized.objectsSampled > 0 ? 100.0 * quantized.falsePositives / quantized.objectsSampled : 0.0);
+            OutputDebugStringA(quantizedBuffer);
+        }
+        m_linearCuller->ResetQuantizedStats();
+    }
+
+    // The BVH's counters are from its last traversal, which may be many frames old
+    if (m_cullingMethod == CullingMethod::Linear && m_linearCuller) {
+        const CullingStats& linear = m_linearCuller->GetStats();
+        char linearBuffer[256];
+        snprintf(linearBuffer, sizeof(linearBuffer),
+            "CPU culling [linear%s]: %.3f ms, objects %d, culled %d, sub-pixel rejects %d, OBB tests %d, OBB rejects %d\n",
+            m_linearCuller->IsUsingQuantizedBounds() ? ", quantized" : "",
+            linear.cullTimeMs, linear.nodesVisited, linear.nodesCulled, linear.smallRejects,
+            linear.orientedTests, linear.orientedRejects);
+        OutputDebugStringA(linearBuffer);
+        return;
+    }
+
+    const CullingStats& stats = m_cpuBVH->GetStats();
+    char buffer[448];
+    snprintf(buffer, sizeof(buffer),
+        "CPU culling [%s%s]: %.3f ms, nodes %d, culled %d, sphere rejects %d, sphere accepts %d, AABB fallbacks %d, "
+        "SAT tests %d, SAT false positives removed %d, sub-pixel rejects %d, HiZ tests %d, HiZ rejects %d, PVS rejects %d, "
+        "OBB tests %d, OBB rejects %d\n",
+        m_cpuBVH->IsUsingBoundingSpheres() ? "sphere+AABB" : "AABB",
+        m_cpuBVH->IsUsingExactTest() ? "+SAT" : "",
+        stats.cullTimeMs, stats.nodesVisited, stats.nodesCulled,
+        stats.sphereRejects, stats.sphereAccepts, stats.aabbFallbacks,
+        stats.satTests, stats.satRejects, stats.smallRejects, stats.hizTests, stats.hizRejects, stats.candidateRejects,
+        stats.orientedTests, stats.orientedRejects);
+    OutputDebugStringA(buffer);
 }
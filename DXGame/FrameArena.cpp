@@ -0,0 +1,124 @@
+#include "FrameArena.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+    size_t AlignUp(size_t value, size_t alignment) {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+}
+
+// ============================================================================
+// FRAME ARENA IMPLEMENTATION
+// ============================================================================
+
+FrameArena::FrameArena(size_t capacity) {
+    m_capacity = std::max<size_t>(capacity, CACHE_LINE_SIZE);
+    m_memory = static_cast<uint8_t*>(AlignedMalloc(m_capacity, CACHE_LINE_SIZE));
+    if (!m_memory) throw std::bad_alloc();
+}
+
+FrameArena::~FrameArena() {
+    Reset();
+    AlignedFree(m_memory);
+}
+
+void* FrameArena::Allocate(size_t size, size_t alignment) {
+    alignment = std::max<size_t>(alignment, alignof(std::max_align_t));
+    size_t start = AlignUp(m_offset, alignment);
+    if (start + size <= m_capacity) {
+        m_offset = start + size;
+        return m_memory + start;
+    }
+
+    // Out of block: this frame gets its own heap block, and Reset grows the arena to fit
+    void* memory = AlignedMalloc(std::max<size_t>(size, 1), alignment);
+    if (!memory) throw std::bad_alloc();
+    m_overflowBlocks.push_back(memory);
+    m_overflowBytes += size;
+    return memory;
+}
+
+void FrameArena::Reset() {
+    m_peakBytes = std::max(m_peakBytes, GetFrameBytes());
+
+    if (!m_overflowBlocks.empty()) {
+        for (void* block : m_overflowBlocks) {
+            AlignedFree(block);
+        }
+        m_overflowBlocks.clear();
+
+        // Half again the frame that overflowed, so slow growth does not regrow every frame
+        size_t capacity = AlignUp(GetFrameBytes() + GetFrameBytes() / 2, CACHE_LINE_SIZE);
+        uint8_t* memory = static_cast<uint8_t*>(AlignedMalloc(capacity, CACHE_LINE_SIZE));
+        if (memory) {
+            AlignedFree(m_memory);
+            m_memory = memory;
+            m_capacity = capacity;
+            m_growthCount++;
+        }
+        m_overflowBytes = 0;
+    }
+    m_offset = 0;
+}
+
+// ============================================================================
+// HEAP ALLOCATION COUNTER (debug builds)
+// ============================================================================
+
+#ifdef _DEBUG
+
+namespace {
+    std::atomic<uint64_t> g_heapAllocations{ 0 };
+}
+
+uint64_t GetHeapAllocationCount() {
+    return g_heapAllocations.load(std::memory_order_relaxed);
+}
+
+void* AlignedMalloc(size_t size, size_t alignment) {
+    g_heapAllocations.fetch_add(1, std::memory_order_relaxed);
+    return _aligned_malloc(size, alignment);
+}
+
+void* operator new(size_t size) {
+    g_heapAllocations.fetch_add(1, std::memory_order_relaxed);
+    void* memory = malloc(size ? size : 1);
+    if (!memory) throw std::bad_alloc();
+    return memory;
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    g_heapAllocations.fetch_add(1, std::memory_order_relaxed);
+    return malloc(size ? size : 1);
+}
+
+void operator delete(void* memory) noexcept {
+    free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept {
+    free(memory);
+}
+
+void operator delete(void* memory, const std::nothrow_t&) noexcept {
+    free(memory);
+}
+
+#else
+
+uint64_t GetHeapAllocationCount() {
+    return 0;
+}
+
+void* AlignedMalloc(size_t size, size_t alignment) {
+    return _aligned_malloc(size, alignment);
+}
+
+#endif
+
+void AlignedFree(void* memory) {
+    _aligned_free(memory);
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "Common.h"
+#include "AlignedAllocator.h"
+
+// ============================================================================
+// FRAME ARENA
+// ============================================================================
+
+// Linear allocator for temporaries that live no longer than a frame. Allocating
+// bumps an offset and Reset at the frame boundary releases everything at once.
+// A frame that outgrows the block takes overflow blocks from the heap; the next
+// Reset replaces them and the block with one block big enough for that frame,
+// so a steady workload stops touching the heap after its first frames.
+class FrameArena {
+public:
+    explicit FrameArena(size_t capacity = Config::FRAME_ARENA_SIZE);
+    ~FrameArena();
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    // Never fails short of the heap itself failing
+    void* Allocate(size_t size, size_t alignment);
+    // Every allocation made since the last Reset is released
+    void Reset();
+
+    size_t GetCapacity() const { return m_capacity; }
+    size_t GetFrameBytes() const { return m_offset + m_overflowBytes; }   // Handed out since the last Reset
+    size_t GetPeakBytes() const { return m_peakBytes; }
+    int GetGrowthCount() const { return m_growthCount; }                   // Times the block was replaced by a bigger one
+    bool HasOverflowed() const { return !m_overflowBlocks.empty(); }
+
+private:
+    uint8_t* m_memory = nullptr;
+    size_t m_capacity = 0;
+    size_t m_offset = 0;
+    std::vector<void*> m_overflowBlocks;
+    size_t m_overflowBytes = 0;
+    size_t m_peakBytes = 0;
+    int m_growthCount = 0;
+};
+
+// std::vector allocator drawing from a frame arena. Freeing is a no-op until the
+// arena resets, so containers should reserve up front rather than grow. Without
+// an arena it falls back to the general heap, for the same code run outside a frame.
+template <typename T>
+struct ArenaAllocator {
+    using value_type = T;
+
+    template <typename U>
+    struct rebind {
+        using other = ArenaAllocator<U>;
+    };
+
+    explicit ArenaAllocator(FrameArena* frameArena = nullptr) : arena(frameArena) {}
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) : arena(other.arena) {}
+
+    T* allocate(size_t count) {
+        if (!arena) return static_cast<T*>(::operator new(count * sizeof(T)));
+        return static_cast<T*>(arena->Allocate(count * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* memory, size_t) {
+        if (!arena) ::operator delete(memory);
+    }
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U>& other) const { return arena == other.arena; }
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U>& other) const { return arena != other.arena; }
+
+    FrameArena* arena;
+};
+
+template <typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+// Global operator new and AlignedMalloc calls so far. Debug builds replace operator
+// new to count them, so a frame can check it left the heap alone; release builds report 0.
+uint64_t GetHeapAllocationCount();
@@ -86,13 +86,16 @@ const char* GPUBVHSystem::GetBVHConstructionShaderSource() {
             int2 padding;
         };
         
+        // Same 64-byte layout as the C++ BVHNode
         struct BVHNode {
-            float4 minBounds;
-            float4 maxBounds;
+            float3 minBounds;
             int leftChild;
+            float3 maxBounds;
             int rightChild;
+            float4 sphere;          // xyz center, w radius
             int objectIndex;
             int isLeaf;
+            int2 padding;
         };
         
         struct BVHConstructionParams {
@@ -137,6 +140,11 @@ const char* GPUBVHSystem::GetBVHConstructionShaderSource() {
             
             return split;
         }
+        // Sphere around a box, so the CPU's sphere test works on a tree read back
+        float4 boxSphere(float3 minBounds, float3 maxBounds) {
+            return float4((minBounds + maxBounds) * 0.5f, length((maxBounds - minBounds) * 0.5f));
+        }
+        
           // Calculate bounding box for a range of objects
         void calculateBounds(int first, int last, out float3 minBounds, out float3 maxBounds) {
             int firstObjIdx = SortedMortonCodes[first].objectIndex;
@@ -164,8 +172,10 @@ const char* GPUBVHSystem::GetBVHConstructionShaderSource() {
                     int objIdx = SortedMortonCodes[leafIndex].objectIndex;
                     ObjectData obj = Objects[objIdx];
                       int leafNodeIndex = numInternalNodes + leafIndex;
-                    BVHNodes[leafNodeIndex].minBounds = float4(obj.minBounds.xyz, 0.0f);
-                    BVHNodes[leafNodeIndex].maxBounds = float4(obj.maxBounds.xyz, 0.0f);                    BVHNodes[leafNodeIndex].leftChild = -1;
+                    BVHNodes[leafNodeIndex].minBounds = obj.minBounds.xyz;
+                    BVHNodes[leafNodeIndex].maxBounds = obj.maxBounds.xyz;
+                    BVHNodes[leafNodeIndex].sphere = boxSphere(obj.minBounds.xyz, obj.maxBounds.xyz);
+                    BVHNodes[leafNodeIndex].leftChild = -1;
                     BVHNodes[leafNodeIndex].rightChild = -1;
                     BVHNodes[leafNodeIndex].objectIndex = objIdx;
                     BVHNodes[leafNodeIndex].isLeaf = 1;
@@ -205,20 +215,24 @@ const char* GPUBVHSystem::GetBVHConstructionShaderSource() {
             
             // Calculate bounding box
             float3 minBounds, maxBounds;
-            calculateBounds(first, last, minBounds, maxBounds);            BVHNodes[nodeIndex].minBounds = float4(minBounds, 0.0f);
-            BVHNodes[nodeIndex].maxBounds = float4(maxBounds, 0.0f);
+            calculateBounds(first, last, minBounds, maxBounds);
+            BVHNodes[nodeIndex].minBounds = minBounds;
+            BVHNodes[nodeIndex].maxBounds = maxBounds;
+            BVHNodes[nodeIndex].sphere = boxSphere(minBounds, maxBounds);
         }
     )";
 }
 
 const char* GPUBVHSystem::GetFrustumCullingShaderSource() {
     return R"(        struct BVHNode {
-            float4 minBounds;
-            float4 maxBounds;
+            float3 minBounds;
             int leftChild;
+            float3 maxBounds;
             int rightChild;
+            float4 sphere;
             int objectIndex;
             int isLeaf;
+            int2 padding;
         };
         
         struct ObjectData {
@@ -231,6 +245,9 @@ const char* GPUBVHSystem::GetFrustumCullingShaderSource() {
         
         struct Frustum {
             float4 planes[6];
+            float4 cameraPosition;
+            float4 cameraForward;
+            float4 screenParams; // pixelsPerUnit, minPixelSize, nearPlane, unused
         };
         
         struct CullingParams {
@@ -244,7 +261,9 @@ const char* GPUBVHSystem::GetFrustumCullingShaderSource() {
         StructuredBuffer<ObjectData> Objects : register(t1);
         ConstantBuffer<Frustum> FrustumData : register(b0);
         ConstantBuffer<CullingParams> Params : register(b1);
-        RWStructuredBuffer<int> Visibility : register(u0);
+        RWStructuredBuffer<uint> Visibility : register(u0);     // One bit per object, 32 to a word
+        
+        groupshared uint GroupVisibility[2];
         
         bool IsBoxInFrustum(float3 minBounds, float3 maxBounds) {
             // Test AABB against all 6 frustum planes using positive vertex test
@@ -264,38 +283,68 @@ const char* GPUBVHSystem::GetFrustumCullingShaderSource() {
                 }
             }
             return true;
-        }        [numthreads(64, 1, 1)]
-        void main(uint3 id : SV_DispatchThreadID) {
-            uint objectIndex = id.x;
-            
-            // Early exit if thread ID exceeds object count
-            if (objectIndex >= (uint)Params.objectCount) {
-                return;
+        }
+        
+        // Projected diameter estimate from the box's nearest view depth
+        bool IsTooSmall(float3 minBounds, float3 maxBounds) {
+            if (FrustumData.screenParams.y <= 0.0f) {
+                return false; // Screen-size culling disabled
             }
             
-            // Initialize visibility to false (conservative approach)
-            Visibility[objectIndex] = 0;
+            float3 center = (minBounds + maxBounds) * 0.5f;
+            float3 extent = (maxBounds - minBounds) * 0.5f;
+            float3 forward = FrustumData.cameraForward.xyz;
             
-            // Get object data (bounds already checked above)
+            float nearestDepth = dot(center - FrustumData.cameraPosition.xyz, forward) - dot(extent, abs(forward));
+            if (nearestDepth <= FrustumData.screenParams.z) {
+                return false; // Touches the near plane
+            }
+            
+            float projectedDiameter = 2.0f * length(extent) * FrustumData.screenParams.x / nearestDepth;
+            return projectedDiameter < FrustumData.screenParams.y;
+        }
+        
+        bool IsObjectVisible(uint objectIndex) {
             ObjectData obj = Objects[objectIndex];
             
             // Skip heavily occluded objects to reduce GPU load
             if (obj.occludedFrameCount > 5) {
-                return;
+                return false;
             }
-              // Validate bounding box before testing
+            // Validate bounding box before testing
             if (any(isnan(obj.minBounds)) || any(isnan(obj.maxBounds)) ||
                 any(obj.minBounds.xyz > obj.maxBounds.xyz)) {
-                return; // Invalid bounds
+                return false; // Invalid bounds
             }
             
             // Test object's bounding box directly against frustum
             if (!IsBoxInFrustum(obj.minBounds.xyz, obj.maxBounds.xyz)) {
-                return; // Outside frustum
+                return false; // Outside frustum
             }
             
-            // Object passed frustum test - mark as visible
-            Visibility[objectIndex] = 1;
+            // Sub-pixel objects are neither drawn nor queried
+            return !IsTooSmall(obj.minBounds.xyz, obj.maxBounds.xyz);
+        }
+        
+        // A group's 64 objects fill two words, gathered in shared memory and written
+        // once, so the buffer needs no clearing and readback is one bit per object
+        [numthreads(64, 1, 1)]
+        void main(uint3 id : SV_DispatchThreadID, uint3 groupId : SV_GroupID, uint groupIndex : SV_GroupIndex) {
+            uint objectIndex = id.x;
+            
+            if (groupIndex < 2) {
+                GroupVisibility[groupIndex] = 0;
+            }
+            GroupMemoryBarrierWithGroupSync();
+            
+            if (objectIndex < (uint)Params.objectCount && IsObjectVisible(objectIndex)) {
+                InterlockedOr(GroupVisibility[groupIndex >> 5], 1u << (groupIndex & 31));
+            }
+            GroupMemoryBarrierWithGroupSync();
+            
+            if (groupIndex < 2) {
+                Visibility[groupId.x * 2 + groupIndex] = GroupVisibility[groupIndex];
+            }
         }
     )";
 }
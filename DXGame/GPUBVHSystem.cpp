@@ -4,6 +4,7 @@ bool GPUBVHSystem::Initialize(ComPtr<ID3D11Device> device, ComPtr<ID3D11DeviceCo
     m_device = device;
     m_context = context;
     m_objectCount = objectCount;
+    m_objectCapacity = std::max(objectCount, 1);
     
     // Check if compute shaders are supported
     D3D11_FEATURE_DATA_D3D10_X_HARDWARE_OPTIONS hwopts = {};
@@ -18,7 +19,7 @@ bool GPUBVHSystem::Initialize(ComPtr<ID3D11Device> device, ComPtr<ID3D11DeviceCo
         return false;
     }
     
-    if (!CreateBuffers(objectCount)) {
+    if (!CreateBuffers(m_objectCapacity)) {
         OutputDebugStringA("Failed to create buffers for GPU BVH system\n");
         return false;
     }
@@ -33,8 +34,8 @@ void GPUBVHSystem::Shutdown() {
     m_context.Reset();
 }
 
-bool GPUBVHSystem::BuildBVH(const std::vector<RenderObject>& objects, const Vector3& sceneMin, const Vector3& sceneMax) {
-    if (objects.empty() || !m_mortonCodeCS || !m_bvhConstructionCS) {
+bool GPUBVHSystem::BuildBVH(const ObjectStore& objects, const Vector3& sceneMin, const Vector3& sceneMax) {
+    if (objects.Empty() || !m_mortonCodeCS || !m_bvhConstructionCS) {
         return false;
     }
     
@@ -51,30 +52,120 @@ bool GPUBVHSystem::BuildBVH(const std::vector<RenderObject>& objects, const Vect
     UpdateBVHQualityMetrics();
     
     // Step 5: Reset state for dynamic updates
+    m_nodeCount = static_cast<int>(objects.Size()) * 2 - 1;
+    m_rootNode = 0;     // GPU-built BVH always has root at index 0
     m_needsRebuild = false;
+    m_editsPending = false;
     m_framesSinceLastRebuild = 0;
     m_accumulatedMovement = 0.0f;
     
     // Initialize position tracking for next frame
-    m_previousPositions.resize(objects.size());
-    for (size_t i = 0; i < objects.size(); i++) {
-        m_previousPositions[i] = objects[i].GetPosition();
+    m_previousPositions.resize(objects.Size());
+    for (size_t i = 0; i < objects.Size(); i++) {
+        m_previousPositions[i] = objects.GetPosition(i);
     }
     
     return true;
 }
 
-bool GPUBVHSystem::RefitBVH(const std::vector<RenderObject>& objects) {
-    if (!m_bvhRefitCS || objects.empty() || !m_bvhNodesBuffer || !m_objectsBuffer) {
+void GPUBVHSystem::InsertObject(const ObjectStore& objects, int objectIndex) {
+    if (!EnsureCapacity(static_cast<int>(objects.Size()))) {
+        OutputDebugStringA("GPU BVH: Failed to grow buffers for new objects\n");
+    }
+    m_objectCount = static_cast<int>(objects.Size());
+    
+    if (m_previousPositions.size() == static_cast<size_t>(objectIndex)) {
+        m_previousPositions.push_back(objects.GetPosition(objectIndex));
+    }
+    m_editsPending = true;
+}
+
+void GPUBVHSystem::RemoveObject(const ObjectRemoval& removal) {
+    m_objectCount = std::max(m_objectCount - 1, 0);
+    
+    // Movement tracking follows the store's swap-remove
+    if (static_cast<size_t>(removal.movedFrom) < m_previousPositions.size()) {
+        m_previousPositions[removal.index] = m_previousPositions[removal.movedFrom];
+        m_previousPositions.resize(removal.movedFrom);
+    }
+    m_editsPending = true;
+}
+
+void GPUBVHSystem::RemapObjects(const ObjectReorder& reorder) {
+    std::vector<Vector3> previousPositions(m_previousPositions.size());
+    for (size_t i = 0; i < m_previousPositions.size() && i < reorder.newIndex.size(); i++) {
+        previousPositions[reorder.newIndex[i]] = m_previousPositions[i];
+    }
+    m_previousPositions.swap(previousPositions);
+    m_editsPending = true;
+}
+
+bool GPUBVHSystem::UploadNodes(const BVHNodePool& nodes, int rootNode) {
+    if (!m_device || nodes.Empty() || rootNode < 0) return false;
+    
+    // Free-list holes can take a CPU tree past the 2n - 1 nodes a GPU build needs
+    if (nodes.Size() > m_nodeCapacity) {
+        CreateBVHNodesBuffer(nodes.Size());
+        if (!m_bvhNodesBuffer) return false;
+    }
+    if (!EnsureNodeStaging()) return false;
+    
+    D3D11_MAPPED_SUBRESOURCE mapped;
+    if (FAILED(m_context->Map(m_bvhNodesStaging.Get(), 0, D3D11_MAP_WRITE, 0, &mapped))) {
+        OutputDebugStringA("GPU BVH: Failed to map node staging buffer for upload\n");
+        return false;
+    }
+    nodes.CopyTo(static_cast<BVHNode*>(mapped.pData));
+    m_context->Unmap(m_bvhNodesStaging.Get(), 0);
+    
+    D3D11_BOX region = { 0, 0, 0, static_cast<UINT>(sizeof(BVHNode) * nodes.Size()), 1, 1 };
+    m_context->CopySubresourceRegion(m_bvhNodesBuffer.Get(), 0, 0, 0, 0, m_bvhNodesStaging.Get(), 0, &region);
+    
+    // The uploaded tree stands in for a GPU build until the next rebuild
+    m_nodeCount = nodes.Size();
+    m_rootNode = rootNode;
+    m_needsRebuild = false;
+    m_editsPending = false;
+    m_framesSinceLastRebuild = 0;
+    m_accumulatedMovement = 0.0f;
+    UpdateCullingParams(m_objectCount);
+    return true;
+}
+
+bool GPUBVHSystem::ReadbackNodes(BVHNodePool& outNodes, int& outRootNode) {
+    // Leaves would still index objects from before the pending edits
+    if (m_needsRebuild || m_editsPending) return false;
+    if (!m_bvhNodesBuffer || m_nodeCount <= 0 || !EnsureNodeStaging()) return false;
+    
+    D3D11_BOX region = { 0, 0, 0, static_cast<UINT>(sizeof(BVHNode) * m_nodeCount), 1, 1 };
+    m_context->CopySubresourceRegion(m_bvhNodesStaging.Get(), 0, 0, 0, 0, m_bvhNodesBuffer.Get(), 0, &region);
+    
+    // Blocks until the copy, and whatever build or refit it follows, has finished
+    D3D11_MAPPED_SUBRESOURCE mapped;
+    if (FAILED(m_context->Map(m_bvhNodesStaging.Get(), 0, D3D11_MAP_READ, 0, &mapped))) {
+        OutputDebugStringA("GPU BVH: Failed to map node staging buffer for readback\n");
+        return false;
+    }
+    outNodes.CopyFrom(static_cast<const BVHNode*>(mapped.pData), m_nodeCount);
+    m_context->Unmap(m_bvhNodesStaging.Get(), 0);
+    
+    outRootNode = m_rootNode;
+    return true;
+}
+
+bool GPUBVHSystem::RefitBVH(const ObjectStore& objects) {
+    if (!m_bvhRefitCS || objects.Empty() || !m_bvhNodesBuffer || !m_objectsBuffer) {
         OutputDebugStringA("GPU BVH Refit: Missing required resources\n");
         return false;
     }
+    // Leaves still index objects from before the pending edits; the re-emit refits anyway
+    if (m_editsPending) return true;
     
     // Use an iterative bottom-up approach for robust BVH refitting
     return RefitBVHBottomUp(objects);
 }
 
-bool GPUBVHSystem::RefitBVHBottomUp(const std::vector<RenderObject>& objects) {
+bool GPUBVHSystem::RefitBVHBottomUp(const ObjectStore& objects) {
     // Update GPU object data with new positions/bounds
     UpdateGPUObjectData(objects);
     
@@ -92,8 +183,7 @@ bool GPUBVHSystem::RefitBVHBottomUp(const std::vector<RenderObject>& objects) {
     m_context->CSSetConstantBuffers(0, 1, cbs);
     
     // Perform iterative bottom-up refitting for better convergence
-    int totalNodes = static_cast<int>(objects.size()) * 2 - 1;
-    int numGroups = (totalNodes + Config::COMPUTE_THREADS_PER_GROUP - 1) / Config::COMPUTE_THREADS_PER_GROUP;
+    int numGroups = (m_nodeCount + Config::COMPUTE_THREADS_PER_GROUP - 1) / Config::COMPUTE_THREADS_PER_GROUP;
     
     for (int iteration = 0; iteration < Config::BVH_REFIT_ITERATIONS; iteration++) {
         m_context->Dispatch(numGroups, 1, 1);
@@ -119,7 +209,7 @@ bool GPUBVHSystem::RefitBVHBottomUp(const std::vector<RenderObject>& objects) {
     return true;
 }
 
-bool GPUBVHSystem::ShouldRebuildBVH(const std::vector<RenderObject>& objects) {
+bool GPUBVHSystem::ShouldRebuildBVH(const ObjectStore& objects) {
     // Increment frame counter
     m_framesSinceLastRebuild++;
     
@@ -129,20 +219,25 @@ bool GPUBVHSystem::ShouldRebuildBVH(const std::vector<RenderObject>& objects) {
         return true;
     }
     
+    // Spawns and despawns are batched into one rebuild per interval
+    if (m_editsPending && m_framesSinceLastRebuild >= Config::GPU_BVH_EDIT_REBUILD_INTERVAL) {
+        return true;
+    }
+    
     // Ensure we have previous positions for comparison
-    if (m_previousPositions.size() != objects.size()) {
-        m_previousPositions.resize(objects.size());
-        for (size_t i = 0; i < objects.size(); i++) {
-            m_previousPositions[i] = objects[i].GetPosition();
+    if (m_previousPositions.size() != objects.Size()) {
+        m_previousPositions.resize(objects.Size());
+        for (size_t i = 0; i < objects.Size(); i++) {
+            m_previousPositions[i] = objects.GetPosition(i);
         }
         return false; // First frame comparison
     }
     
     // Calculate accumulated movement since last rebuild
     float frameMovement = 0.0f;
-    for (size_t i = 0; i < objects.size(); i++) {
-        if (objects[i].isDynamic) {
-            Vector3 currentPos = objects[i].GetPosition();
+    for (size_t i = 0; i < objects.Size(); i++) {
+        if (objects.dynamic[i]) {
+            Vector3 currentPos = objects.GetPosition(i);
             Vector3 movement = currentPos - m_previousPositions[i];
             frameMovement += movement.Length();
             m_previousPositions[i] = currentPos;
@@ -195,8 +290,8 @@ float GPUBVHSystem::CalculateSurfaceAreaHeuristic() const {
     return m_accumulatedMovement * 100.0f + 1000.0f;
 }
 
-bool GPUBVHSystem::PerformFrustumCulling(const Frustum& frustum, std::vector<RenderObject>& objects) {
-    if (!m_frustumCullingCS || objects.empty() || !m_bvhNodesBuffer || !m_objectsBuffer) {
+bool GPUBVHSystem::PerformFrustumCulling(const Frustum& frustum, ObjectStore& objects) {
+    if (!m_frustumCullingCS || objects.Empty() || !m_bvhNodesBuffer || !m_objectsBuffer) {
         OutputDebugStringA("GPU Frustum Culling: Missing required resources\n");
         return false;
     }
@@ -205,7 +300,7 @@ bool GPUBVHSystem::PerformFrustumCulling(const Frustum& frustum, std::vector<Ren
         // Update GPU data for current frame
         UpdateGPUObjectData(objects);
         UpdateFrustumData(frustum);
-        UpdateCullingParams(static_cast<int>(objects.size()));
+        UpdateCullingParams(static_cast<int>(objects.Size()));
         
         // Set compute shader and resources
         m_context->CSSetShader(m_frustumCullingCS.Get(), nullptr, 0);
@@ -221,7 +316,7 @@ bool GPUBVHSystem::PerformFrustumCulling(const Frustum& frustum, std::vector<Ren
         m_context->CSSetUnorderedAccessViews(0, 1, uavs, initialCounts);
         
         // Dispatch compute shader - one thread per object for simplicity and efficiency
-        int numGroups = (static_cast<int>(objects.size()) + Config::COMPUTE_THREADS_PER_GROUP - 1) / Config::COMPUTE_THREADS_PER_GROUP;
+        int numGroups = (static_cast<int>(objects.Size()) + Config::COMPUTE_THREADS_PER_GROUP - 1) / Config::COMPUTE_THREADS_PER_GROUP;
         m_context->Dispatch(numGroups, 1, 1);
         
         // Unbind resources first
@@ -241,11 +336,12 @@ bool GPUBVHSystem::PerformFrustumCulling(const Frustum& frustum, std::vector<Ren
         HRESULT hr = m_context->Map(m_visibilityReadbackBuffer.Get(), 0, D3D11_MAP_READ, D3D11_MAP_FLAG_DO_NOT_WAIT, &mapped);
         
         if (SUCCEEDED(hr)) {
-            // Results available immediately - update object visibility
-            const int* visibility = static_cast<const int*>(mapped.pData);
-            
-            for (size_t i = 0; i < objects.size() && i < static_cast<size_t>(m_objectCount); i++) {
-                objects[i].visible = (visibility[i] != 0);
+            // Results available immediately - two 32-bit words make each 64-bit visibility word
+            const uint32_t* visibility = static_cast<const uint32_t*>(mapped.pData);
+            uint64_t* visibleWords = objects.visible.Words();
+            size_t wordCount = std::min(objects.visible.WordCount(), static_cast<size_t>(GetVisibilityWordCount(m_objectCapacity) / 2));
+            for (size_t w = 0; w < wordCount; w++) {
+                visibleWords[w] = visibility[2 * w] | (static_cast<uint64_t>(visibility[2 * w + 1]) << 32);
             }
             
             m_context->Unmap(m_visibilityReadbackBuffer.Get(), 0);
@@ -323,6 +419,20 @@ bool GPUBVHSystem::CreateBuffers(int objectCount) {
     }
 }
 
+bool GPUBVHSystem::EnsureCapacity(int objectCount) {
+    if (objectCount <= m_objectCapacity) return true;
+    if (!m_device) return false;
+    
+    // Doubling keeps the reallocations logarithmic in the number of spawns
+    int capacity = std::max(objectCount, m_objectCapacity * 2);
+    if (!CreateBuffers(capacity)) {
+        return false;
+    }
+    m_objectCapacity = capacity;
+    m_needsRebuild = true;      // The new node buffer holds no tree
+    return true;
+}
+
 bool GPUBVHSystem::CompileAndCreateComputeShader(const char* source, ComPtr<ID3D11ComputeShader>* outShader) {
     ComPtr<ID3DBlob> csBlob;
     ComPtr<ID3DBlob> errorBlob;
@@ -413,6 +523,8 @@ void GPUBVHSystem::CreateBVHNodesBuffer(int nodeCount) {
     bufferDesc.MiscFlags = D3D11_RESOURCE_MISC_BUFFER_STRUCTURED;
     
     m_device->CreateBuffer(&bufferDesc, nullptr, &m_bvhNodesBuffer);
+    m_nodeCapacity = nodeCount;
+    m_bvhNodesStaging.Reset();
     
     // Create SRV
     D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
@@ -431,6 +543,23 @@ void GPUBVHSystem::CreateBVHNodesBuffer(int nodeCount) {
     m_device->CreateUnorderedAccessView(m_bvhNodesBuffer.Get(), &uavDesc, &m_bvhNodesUAV);
 }
 
+bool GPUBVHSystem::EnsureNodeStaging() {
+    if (m_bvhNodesStaging) return true;
+    
+    // Same size as the node buffer, so one map covers any tree it holds
+    D3D11_BUFFER_DESC bufferDesc = {};
+    bufferDesc.Usage = D3D11_USAGE_STAGING;
+    bufferDesc.ByteWidth = sizeof(BVHNode) * m_nodeCapacity;
+    bufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_READ | D3D11_CPU_ACCESS_WRITE;
+    bufferDesc.StructureByteStride = sizeof(BVHNode);
+    
+    if (FAILED(m_device->CreateBuffer(&bufferDesc, nullptr, &m_bvhNodesStaging))) {
+        OutputDebugStringA("GPU BVH: Failed to create node staging buffer\n");
+        return false;
+    }
+    return true;
+}
+
 void GPUBVHSystem::CreateObjectsBuffer(int objectCount) {
     D3D11_BUFFER_DESC bufferDesc = {};
     bufferDesc.Usage = D3D11_USAGE_DYNAMIC;
@@ -451,11 +580,13 @@ void GPUBVHSystem::CreateObjectsBuffer(int objectCount) {
 }
 
 void GPUBVHSystem::CreateVisibilityBuffer(int objectCount) {
+    static_assert(Config::COMPUTE_THREADS_PER_GROUP == 64, "The culling shader packs a group into two 32-bit words");
+    int wordCount = GetVisibilityWordCount(objectCount);
     D3D11_BUFFER_DESC bufferDesc = {};
     bufferDesc.Usage = D3D11_USAGE_DEFAULT;
-    bufferDesc.ByteWidth = sizeof(int) * objectCount;
+    bufferDesc.ByteWidth = sizeof(uint32_t) * wordCount;
     bufferDesc.BindFlags = D3D11_BIND_UNORDERED_ACCESS;
-    bufferDesc.StructureByteStride = sizeof(int);
+    bufferDesc.StructureByteStride = sizeof(uint32_t);
     bufferDesc.MiscFlags = D3D11_RESOURCE_MISC_BUFFER_STRUCTURED;
     
     m_device->CreateBuffer(&bufferDesc, nullptr, &m_visibilityBuffer);
@@ -463,7 +594,7 @@ void GPUBVHSystem::CreateVisibilityBuffer(int objectCount) {
     D3D11_UNORDERED_ACCESS_VIEW_DESC uavDesc = {};
     uavDesc.Format = DXGI_FORMAT_UNKNOWN;
     uavDesc.ViewDimension = D3D11_UAV_DIMENSION_BUFFER;
-    uavDesc.Buffer.NumElements = objectCount;
+    uavDesc.Buffer.NumElements = wordCount;
     
     m_device->CreateUnorderedAccessView(m_visibilityBuffer.Get(), &uavDesc, &m_visibilityUAV);
     
@@ -495,8 +626,8 @@ void GPUBVHSystem::CreateConstantBuffers() {
     m_device->CreateBuffer(&cbDesc, nullptr, &m_bvhConstructionParamsBuffer);
 }
 
-void GPUBVHSystem::GenerateMortonCodes(const std::vector<RenderObject>& objects, const Vector3& sceneMin, const Vector3& sceneMax) {
-    UpdateBVHConstructionParams(static_cast<int>(objects.size()), sceneMin, sceneMax);
+void GPUBVHSystem::GenerateMortonCodes(const ObjectStore& objects, const Vector3& sceneMin, const Vector3& sceneMax) {
+    UpdateBVHConstructionParams(static_cast<int>(objects.Size()), sceneMin, sceneMax);
     UpdateGPUObjectData(objects);
     
     m_context->CSSetShader(m_mortonCodeCS.Get(), nullptr, 0);
@@ -511,7 +642,7 @@ void GPUBVHSystem::GenerateMortonCodes(const std::vector<RenderObject>& objects,
     UINT initialCounts[] = { 0 };
     m_context->CSSetUnorderedAccessViews(0, 1, uavs, initialCounts);
     
-    int numGroups = (static_cast<int>(objects.size()) + Config::COMPUTE_THREADS_PER_GROUP - 1) / Config::COMPUTE_THREADS_PER_GROUP;
+    int numGroups = (static_cast<int>(objects.Size()) + Config::COMPUTE_THREADS_PER_GROUP - 1) / Config::COMPUTE_THREADS_PER_GROUP;
     m_context->Dispatch(numGroups, 1, 1);
     
     // Unbind resources
@@ -531,7 +662,7 @@ void GPUBVHSystem::SortMortonCodes() {
     ComPtr<ID3D11Buffer> stagingBuffer;
     D3D11_BUFFER_DESC bufferDesc = {};
     bufferDesc.Usage = D3D11_USAGE_STAGING;
-    bufferDesc.ByteWidth = sizeof(GPUMortonCode) * m_objectCount;
+    bufferDesc.ByteWidth = sizeof(GPUMortonCode) * m_objectCapacity;
     bufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_READ | D3D11_CPU_ACCESS_WRITE;
     bufferDesc.StructureByteStride = sizeof(GPUMortonCode);
     
@@ -599,29 +730,29 @@ void GPUBVHSystem::UpdateBVHConstructionParams(int objectCount, const Vector3& s
     }
 }
 
-void GPUBVHSystem::UpdateGPUObjectData(const std::vector<RenderObject>& objects) {
-    if (!m_objectsBuffer || objects.empty()) return;
+void GPUBVHSystem::UpdateGPUObjectData(const ObjectStore& objects) {
+    if (!m_objectsBuffer || objects.Empty()) return;
     
     D3D11_MAPPED_SUBRESOURCE mapped;
     HRESULT hr = m_context->Map(m_objectsBuffer.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped);
     if (SUCCEEDED(hr)) {
-        GPUObjectData* gpuObjects = static_cast<GPUObjectData*>(mapped.pData);        for (size_t i = 0; i < objects.size() && i < static_cast<size_t>(m_objectCount); i++) {
-            const auto& obj = objects[i];
+        GPUObjectData* gpuObjects = static_cast<GPUObjectData*>(mapped.pData);        for (size_t i = 0; i < objects.Size() && i < static_cast<size_t>(m_objectCapacity); i++) {
+            const ObjectBounds& bounds = objects.bounds[i];
             auto& gpuObj = gpuObjects[i];
             
             // Copy bounds data using float4 arrays
-            gpuObj.minBounds[0] = obj.minBounds.x;
-            gpuObj.minBounds[1] = obj.minBounds.y;
-            gpuObj.minBounds[2] = obj.minBounds.z;
+            gpuObj.minBounds[0] = bounds.minBounds.x;
+            gpuObj.minBounds[1] = bounds.minBounds.y;
+            gpuObj.minBounds[2] = bounds.minBounds.z;
             gpuObj.minBounds[3] = 0.0f;
             
-            gpuObj.maxBounds[0] = obj.maxBounds.x;
-            gpuObj.maxBounds[1] = obj.maxBounds.y;
-            gpuObj.maxBounds[2] = obj.maxBounds.z;
+            gpuObj.maxBounds[0] = bounds.maxBounds.x;
+            gpuObj.maxBounds[1] = bounds.maxBounds.y;
+            gpuObj.maxBounds[2] = bounds.maxBounds.z;
             gpuObj.maxBounds[3] = 0.0f;
             
             gpuObj.objectIndex = static_cast<int>(i);
-            gpuObj.occludedFrameCount = obj.occludedFrameCount;
+            gpuObj.occludedFrameCount = objects.queries[i].occludedFrameCount;
             gpuObj.padding[0] = 0;
             gpuObj.padding[1] = 0;
         }
@@ -641,6 +772,19 @@ void GPUBVHSystem::UpdateFrustumData(const Frustum& frustum) {
             gpuFrustum->planes[i][2] = frustum.planes[i].z;
             gpuFrustum->planes[i][3] = frustum.planes[i].w;
         }
+        
+        gpuFrustum->cameraPosition[0] = m_screenSize.cameraPosition.x;
+        gpuFrustum->cameraPosition[1] = m_screenSize.cameraPosition.y;
+        gpuFrustum->cameraPosition[2] = m_screenSize.cameraPosition.z;
+        gpuFrustum->cameraPosition[3] = 0.0f;
+        gpuFrustum->cameraForward[0] = m_screenSize.cameraForward.x;
+        gpuFrustum->cameraForward[1] = m_screenSize.cameraForward.y;
+        gpuFrustum->cameraForward[2] = m_screenSize.cameraForward.z;
+        gpuFrustum->cameraForward[3] = 0.0f;
+        gpuFrustum->screenParams[0] = m_screenSize.pixelsPerUnit;
+        gpuFrustum->screenParams[1] = m_screenSize.IsEnabled() ? m_screenSize.minPixelSize : 0.0f;
+        gpuFrustum->screenParams[2] = m_screenSize.nearPlane;
+        gpuFrustum->screenParams[3] = 0.0f;
         m_context->Unmap(m_frustumBuffer.Get(), 0);
     }
 }
@@ -650,9 +794,9 @@ void GPUBVHSystem::UpdateCullingParams(int objectCount) {
     HRESULT hr = m_context->Map(m_cullingParamsBuffer.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped);
     if (SUCCEEDED(hr)) {
         CullingParams* params = static_cast<CullingParams*>(mapped.pData);
-        params->rootNodeIndex = 0; // GPU-built BVH always has root at index 0
+        params->rootNodeIndex = m_rootNode;
         params->objectCount = objectCount;
-        params->nodeCount = objectCount * 2 - 1;
+        params->nodeCount = m_nodeCount;
         params->maxDepth = Config::MAX_BVH_DEPTH;
         m_context->Unmap(m_cullingParamsBuffer.Get(), 0);
     }
@@ -668,14 +812,20 @@ cbuffer CullingParams : register(b0) {
 };
 
 struct GPUBVHNode {
-    float4 minBounds;
-    float4 maxBounds;
+    float3 minBounds;
     int leftChild;
+    float3 maxBounds;
     int rightChild;
+    float4 sphere;
     int objectIndex;
     int isLeaf;
+    int2 padding;
 };
 
+float4 BoxSphere(float3 minBounds, float3 maxBounds) {
+    return float4((minBounds + maxBounds) * 0.5f, length((maxBounds - minBounds) * 0.5f));
+}
+
 struct GPUObjectData {
     float4 minBounds;
     float4 maxBounds;
@@ -696,11 +846,15 @@ void main(uint3 id : SV_DispatchThreadID) {
     
     GPUBVHNode node = BVHNodes[nodeIndex];
     
+    // Free-list entries of an uploaded CPU tree: leftChild links the list, not a child
+    if (node.rightChild == -2) return;
+    
     if (node.isLeaf) {        // Update leaf nodes with new object bounds
         if (node.objectIndex >= 0 && node.objectIndex < objectCount) {
             GPUObjectData objData = ObjectData[node.objectIndex];
-            BVHNodes[nodeIndex].minBounds = objData.minBounds;
-            BVHNodes[nodeIndex].maxBounds = objData.maxBounds;
+            BVHNodes[nodeIndex].minBounds = objData.minBounds.xyz;
+            BVHNodes[nodeIndex].maxBounds = objData.maxBounds.xyz;
+            BVHNodes[nodeIndex].sphere = BoxSphere(objData.minBounds.xyz, objData.maxBounds.xyz);
         }
     } else {
         // Update internal nodes by encompassing child bounds
@@ -714,8 +868,9 @@ void main(uint3 id : SV_DispatchThreadID) {
             float3 newMaxBounds = max(leftChild.maxBounds.xyz, rightChild.maxBounds.xyz);
             
             // Atomic update to prevent race conditions
-            BVHNodes[nodeIndex].minBounds = float4(newMinBounds, 0.0f);
-            BVHNodes[nodeIndex].maxBounds = float4(newMaxBounds, 0.0f);
+            BVHNodes[nodeIndex].minBounds = newMinBounds;
+            BVHNodes[nodeIndex].maxBounds = newMaxBounds;
+            BVHNodes[nodeIndex].sphere = BoxSphere(newMinBounds, newMaxBounds);
         }
     }
     
@@ -725,46 +880,51 @@ void main(uint3 id : SV_DispatchThreadID) {
 )";
 }
 
-void GPUBVHSystem::UpdateDynamicObjects(std::vector<RenderObject>& objects, float deltaTime) {
+void GPUBVHSystem::UpdateDynamicObjects(ObjectStore& objects, float deltaTime) {
     bool hasMovingObjects = false;
     
-    for (auto& obj : objects) {
-        if (obj.isDynamic) {
+    m_movedObjects.clear();
+    for (size_t i = 0; i < objects.Size(); i++) {
+        if (objects.dynamic[i]) {
+            ObjectMotion& motion = objects.motion[i];
+
             // Store previous position for movement tracking
-            obj.previousPosition = obj.GetPosition();
+            motion.previousPosition = objects.GetPosition(i);
             
             // Update animation time
-            obj.animationTime += deltaTime;
+            motion.animationTime += deltaTime;
             
             // Calculate new position based on circular motion
-            Vector3 newPosition = obj.animationCenter + Vector3(
-                cos(obj.animationTime) * obj.animationRadius,
+            Vector3 newPosition = motion.animationCenter + Vector3(
+                cos(motion.animationTime) * motion.animationRadius,
                 0.0f,
-                sin(obj.animationTime) * obj.animationRadius
+                sin(motion.animationTime) * motion.animationRadius
             );
             
             // Calculate movement distance for this frame
-            obj.movementDistance = (newPosition - obj.previousPosition).Length();
+            motion.movementDistance = (newPosition - motion.previousPosition).Length();
             
-            // Update world matrix with new position
-            obj.world = Matrix::CreateTranslation(newPosition);
-            
-            // Update object's bounding box based on new position
-            obj.UpdateBounds();
+            // Update position
+            objects.transforms[i].position = newPosition;
+            m_movedObjects.push_back(static_cast<uint32_t>(i));
             
             // Track if any objects are moving significantly
-            if (obj.movementDistance > Config::MOVEMENT_THRESHOLD) {
+            if (motion.movementDistance > Config::MOVEMENT_THRESHOLD) {
                 hasMovingObjects = true;
             }
         }
     }
     
+    // Update the moved objects' bounding boxes based on their new positions
+    objects.UpdateBounds(m_movedObjects.data(), m_movedObjects.size());
+    
     // Update velocity for all dynamic objects (for future prediction if needed)
-    for (auto& obj : objects) {
-        if (obj.isDynamic) {
-            Vector3 currentPos = obj.GetPosition();
+    for (size_t i = 0; i < objects.Size(); i++) {
+        if (objects.dynamic[i]) {
+            ObjectMotion& motion = objects.motion[i];
+            Vector3 currentPos = objects.GetPosition(i);
             if (deltaTime > 0.0f) {
-                obj.velocity = (currentPos - obj.previousPosition) / deltaTime;
+                motion.velocity = (currentPos - motion.previousPosition) / deltaTime;
             }
         }
     }
@@ -2,6 +2,8 @@
 
 #include "Common.h"
 #include "Structures.h"
+#include "ObjectStore.h"
+#include "BVHNodePool.h"
 
 // ============================================================================
 // GPU BVH SYSTEM CLASS
@@ -15,15 +17,36 @@ public:
     // Initialization
     bool Initialize(ComPtr<ID3D11Device> device, ComPtr<ID3D11DeviceContext> context, int objectCount);
     void Shutdown();    // BVH operations
-    bool BuildBVH(const std::vector<RenderObject>& objects, const Vector3& sceneMin, const Vector3& sceneMax);
-    bool PerformFrustumCulling(const Frustum& frustum, std::vector<RenderObject>& objects);
-    bool RefitBVH(const std::vector<RenderObject>& objects);
+    bool BuildBVH(const ObjectStore& objects, const Vector3& sceneMin, const Vector3& sceneMax);
+    bool PerformFrustumCulling(const Frustum& frustum, ObjectStore& objects);
+    bool RefitBVH(const ObjectStore& objects);
+    
+    // Objects spawned or despawned at runtime. A Morton-ordered linear BVH has no
+    // in-place insert; the tree is re-emitted by the GPU build pass, at most once per
+    // Config::GPU_BVH_EDIT_REBUILD_INTERVAL frames however many edits arrive. Culling
+    // runs per object from the object buffer, so it stays exact in between; refits
+    // wait for the re-emit. Buffers grow geometrically and never re-initialize the system.
+    void InsertObject(const ObjectStore& objects, int objectIndex);
+    void RemoveObject(const ObjectRemoval& removal);
+    // The store was reordered; the tree is re-emitted like after a spawn
+    void RemapObjects(const ObjectReorder& reorder);
+    
+    // Trees move between the CPU and GPU systems as raw BVHNode arrays. UploadNodes
+    // copies a CPU-built tree into the node buffer through one staging map, and the
+    // refit pass then follows its root. ReadbackNodes waits for the GPU and copies
+    // the current tree out the same way, for CPUBVHSystem::AdoptTree; it fails while
+    // spawns and despawns wait for the next rebuild.
+    bool UploadNodes(const BVHNodePool& nodes, int rootNode);
+    bool ReadbackNodes(BVHNodePool& outNodes, int& outRootNode);
     
     // Dynamic object management
-    void UpdateDynamicObjects(std::vector<RenderObject>& objects, float deltaTime);
-    bool ShouldRebuildBVH(const std::vector<RenderObject>& objects);
+    void UpdateDynamicObjects(ObjectStore& objects, float deltaTime);
+    bool ShouldRebuildBVH(const ObjectStore& objects);
     float CalculateBVHQuality() const;
     
+    // Projected-size culling, evaluated per object in the culling shader
+    void SetScreenSizeCulling(const ScreenSizeCullParams& params) { m_screenSize = params; }
+    
     // State management
     void MarkForRebuild() { m_needsRebuild = true; }
     bool NeedsRebuild() const { return m_needsRebuild; }
@@ -56,12 +79,20 @@ private:
     ComPtr<ID3D11UnorderedAccessView> m_bvhConstructionUAV;
     ComPtr<ID3D11UnorderedAccessView> m_mortonCodesUAV;
     ComPtr<ID3D11UnorderedAccessView> m_visibilityUAV;
+    ComPtr<ID3D11Buffer> m_bvhNodesStaging;     // Created on the first tree transfer
     ComPtr<ID3D11Buffer> m_visibilityReadbackBuffer;    // State tracking for intelligent BVH management
     bool m_needsRebuild = true;
+    bool m_editsPending = false;  // Tree leaves index objects from before a spawn or despawn
     int m_objectCount = 0;
+    int m_objectCapacity = 0;     // Size of every per-object buffer
+    int m_nodeCount = 0;          // Nodes in the current tree, free ones included for an uploaded tree
+    int m_nodeCapacity = 0;
+    int m_rootNode = 0;
     int m_framesSinceLastRebuild = 0;
     float m_accumulatedMovement = 0.0f;
     std::vector<Vector3> m_previousPositions;
+    std::vector<uint32_t> m_movedObjects;       // Bounds refreshed in one batch after animating
+    ScreenSizeCullParams m_screenSize;
     
     // BVH quality metrics
     float m_initialBVHSurfaceArea = 0.0f;
@@ -70,20 +101,26 @@ private:
     // Initialization helpers
     bool CreateComputeShaders();
     bool CreateBuffers(int objectCount);
+    bool EnsureCapacity(int objectCount);
     bool CompileAndCreateComputeShader(const char* source, ComPtr<ID3D11ComputeShader>* outShader);
     
     // Buffer creation helpers
     void CreateMortonCodesBuffer(int objectCount);
     void CreateBVHConstructionBuffer(int nodeCount);
     void CreateBVHNodesBuffer(int nodeCount);
+    bool EnsureNodeStaging();
     void CreateObjectsBuffer(int objectCount);
     void CreateVisibilityBuffer(int objectCount);
+    // 32-bit words the culling shader writes: two per thread group, whole groups only
+    static int GetVisibilityWordCount(int objectCount) {
+        return (objectCount + Config::COMPUTE_THREADS_PER_GROUP - 1) / Config::COMPUTE_THREADS_PER_GROUP * 2;
+    }
     void CreateConstantBuffers();
       // BVH construction and updates
-    void GenerateMortonCodes(const std::vector<RenderObject>& objects, const Vector3& sceneMin, const Vector3& sceneMax);
+    void GenerateMortonCodes(const ObjectStore& objects, const Vector3& sceneMin, const Vector3& sceneMax);
     void SortMortonCodes();
     void ConstructBVHOnGPU();
-    bool RefitBVHBottomUp(const std::vector<RenderObject>& objects);
+    bool RefitBVHBottomUp(const ObjectStore& objects);
     
     // Quality and decision making
     float CalculateSurfaceAreaHeuristic() const;
@@ -91,7 +128,7 @@ private:
     
     // Data updates
     void UpdateBVHConstructionParams(int objectCount, const Vector3& sceneMin, const Vector3& sceneMax);
-    void UpdateGPUObjectData(const std::vector<RenderObject>& objects);
+    void UpdateGPUObjectData(const ObjectStore& objects);
     void UpdateFrustumData(const Frustum& frustum);
     void UpdateCullingParams(int objectCount);
     
@@ -0,0 +1,111 @@
+#include "HiZPyramid.h"
+
+void HiZPyramid::Build(const std::vector<float>& depth, int width, int height, const Matrix& viewProjection) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+    m_viewProjection = viewProjection;
+    m_levelCount = 0;
+    if (width <= 0 || height <= 0 || depth.size() < static_cast<size_t>(width) * height) return;
+
+    // Level 0 is a copy of the source, every level after halves it down to 1x1
+    int levelCount = 1;
+    for (int w = width, h = height; w > 1 || h > 1; w = (w + 1) / 2, h = (h + 1) / 2) {
+        levelCount++;
+    }
+    if (static_cast<int>(m_levels.size()) < levelCount) {
+        m_levels.resize(levelCount);
+    }
+
+    m_levels[0].width = width;
+    m_levels[0].height = height;
+    m_levels[0].depth.assign(depth.begin(), depth.begin() + static_cast<size_t>(width) * height);
+
+    for (int level = 1; level < levelCount; level++) {
+        const Level& source = m_levels[level - 1];
+        Level& target = m_levels[level];
+        target.width = (source.width + 1) / 2;
+        target.height = (source.height + 1) / 2;
+        target.depth.resize(static_cast<size_t>(target.width) * target.height);
+        Downsample(source, target);
+    }
+
+    m_levelCount = levelCount;
+    m_buildTimeMs = std::chrono::duration<float, std::milli>(
+        std::chrono::high_resolution_clock::now() - startTime).count();
+}
+
+void HiZPyramid::Downsample(const Level& source, Level& target) {
+    // Even dimensions with a row width multiple of 8 take the SIMD path: two source
+    // rows are maxed, then even/odd lanes are separated and maxed - 4 texels per step
+    bool simd = (source.width % 8) == 0 && (source.height % 2) == 0;
+
+    for (int y = 0; y < target.height; y++) {
+        int sourceY0 = y * 2;
+        int sourceY1 = std::min(sourceY0 + 1, source.height - 1);
+        const float* row0 = &source.depth[static_cast<size_t>(sourceY0) * source.width];
+        const float* row1 = &source.depth[static_cast<size_t>(sourceY1) * source.width];
+        float* output = &target.depth[static_cast<size_t>(y) * target.width];
+
+        if (simd) {
+            for (int x = 0; x < target.width; x += 4) {
+                const float* top = row0 + x * 2;
+                const float* bottom = row1 + x * 2;
+                XMVECTOR low = XMVectorMax(XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(top)),
+                                           XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(bottom)));
+                XMVECTOR high = XMVectorMax(XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(top + 4)),
+                                            XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(bottom + 4)));
+                XMVECTOR even = XMVectorPermute<0, 2, 4, 6>(low, high);
+                XMVECTOR odd = XMVectorPermute<1, 3, 5, 7>(low, high);
+                XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(output + x), XMVectorMax(even, odd));
+            }
+        } else {
+            // Odd edges clamp, so the last texel only covers the pixels that exist
+            for (int x = 0; x < target.width; x++) {
+                int sourceX0 = x * 2;
+                int sourceX1 = std::min(sourceX0 + 1, source.width - 1);
+                output[x] = std::max(std::max(row0[sourceX0], row0[sourceX1]),
+                                     std::max(row1[sourceX0], row1[sourceX1]));
+            }
+        }
+    }
+}
+
+bool HiZPyramid::IsOccluded(const Vector3& minBounds, const Vector3& maxBounds) const {
+    if (!IsValid()) return false;
+
+    ScreenBounds bounds;
+    if (!bounds.FromBox(m_viewProjection, static_cast<float>(m_levels[0].width), static_cast<float>(m_levels[0].height),
+                        minBounds, maxBounds)) {
+        return false; // Touches the near plane, it covers the camera
+    }
+    return IsOccluded(bounds);
+}
+
+bool HiZPyramid::IsOccluded(const ScreenBounds& bounds) const {
+    if (!IsValid()) return false;
+
+    const Level& base = m_levels[0];
+    int x0 = std::max(static_cast<int>(floorf(bounds.minX)), 0);
+    int x1 = std::min(static_cast<int>(floorf(bounds.maxX)), base.width - 1);
+    int y0 = std::max(static_cast<int>(floorf(bounds.minY)), 0);
+    int y1 = std::min(static_cast<int>(floorf(bounds.maxY)), base.height - 1);
+    if (x0 > x1 || y0 > y1) {
+        return false;
+    }
+
+    // Coarsest detail where the footprint still spans at most 2x2 texels
+    int level = 0;
+    while (level + 1 < m_levelCount && ((x1 >> level) - (x0 >> level) > 1 || (y1 >> level) - (y0 >> level) > 1)) {
+        level++;
+    }
+
+    const Level& mip = m_levels[level];
+    for (int y = y0 >> level; y <= (y1 >> level); y++) {
+        const float* row = &mip.depth[static_cast<size_t>(y) * mip.width];
+        for (int x = x0 >> level; x <= (x1 >> level); x++) {
+            if (row[x] >= bounds.nearestDepth) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "Common.h"
+#include "Structures.h"
+
+// ============================================================================
+// HIERARCHICAL-Z PYRAMID CLASS (CPU)
+// ============================================================================
+
+// Max-depth mip chain over a CPU depth target. Each texel holds the farthest
+// depth below it, so a box whose nearest depth is behind every texel of a
+// coarse 2x2 footprint is hidden - one projection and at most four loads,
+// cheap enough to run on every BVH node.
+class HiZPyramid {
+public:
+    HiZPyramid() = default;
+    ~HiZPyramid() = default;
+
+    // Builds the chain from a depth buffer in NDC depth (1.0 = empty)
+    void Build(const std::vector<float>& depth, int width, int height, const Matrix& viewProjection);
+    void Clear() { m_levelCount = 0; }
+
+    bool IsOccluded(const Vector3& minBounds, const Vector3& maxBounds) const;
+    bool IsOccluded(const ScreenBounds& bounds) const;
+
+    // State queries
+    bool IsValid() const { return m_levelCount > 0; }
+    int GetLevelCount() const { return m_levelCount; }
+    float GetBuildTimeMs() const { return m_buildTimeMs; }
+
+private:
+    struct Level {
+        int width = 0;
+        int height = 0;
+        std::vector<float> depth;
+    };
+
+    std::vector<Level> m_levels;   // Kept across frames so rebuilding does not allocate
+    int m_levelCount = 0;
+    Matrix m_viewProjection;
+    float m_buildTimeMs = 0.0f;
+
+    static void Downsample(const Level& source, Level& target);
+};
@@ -0,0 +1,286 @@
+#include "LinearCullingSystem.h"
+#include <DirectXPackedVector.h>
+
+using namespace DirectX::PackedVector;
+
+namespace {
+    // Each frustum plane splatted across four lanes, so one pass tests four boxes
+    struct PlaneSplats {
+        XMVECTOR x[6], y[6], z[6], w[6];
+        XMVECTOR absX[6], absY[6], absZ[6];
+        
+        explicit PlaneSplats(const Frustum& frustum) {
+            for (int p = 0; p < 6; p++) {
+                x[p] = XMVectorReplicate(frustum.planes[p].x);
+                y[p] = XMVectorReplicate(frustum.planes[p].y);
+                z[p] = XMVectorReplicate(frustum.planes[p].z);
+                w[p] = XMVectorReplicate(frustum.planes[p].w);
+                absX[p] = XMVectorAbs(x[p]);
+                absY[p] = XMVectorAbs(y[p]);
+                absZ[p] = XMVectorAbs(z[p]);
+            }
+        }
+        
+        // All bits set in the lanes whose box is outside some plane
+        XMVECTOR TestBoxes(FXMVECTOR cx, FXMVECTOR cy, FXMVECTOR cz, GXMVECTOR ex, HXMVECTOR ey, HXMVECTOR ez) const {
+            XMVECTOR outside = XMVectorFalseInt();
+            for (int p = 0; p < 6; p++) {
+                // Outside when dot(n, c) + w + dot(|n|, e) < 0
+                XMVECTOR distance = XMVectorMultiplyAdd(x[p], cx, w[p]);
+                distance = XMVectorMultiplyAdd(y[p], cy, distance);
+                distance = XMVectorMultiplyAdd(z[p], cz, distance);
+                
+                XMVECTOR radius = XMVectorMultiply(absX[p], ex);
+                radius = XMVectorMultiplyAdd(absY[p], ey, radius);
+                radius = XMVectorMultiplyAdd(absZ[p], ez, radius);
+                
+                outside = XMVectorOrInt(outside, XMVectorLess(XMVectorAdd(distance, radius), XMVectorZero()));
+            }
+            return outside;
+        }
+    };
+    
+    // Largest code that decodes at or below value; the loop absorbs the division's rounding
+    uint16_t QuantizeDown(float value, float origin, float step) {
+        if (step <= 0.0f) return 0;
+        int code = std::min(std::max(static_cast<int>(floorf((value - origin) / step)), 0), 65535);
+        while (code > 0 && origin + static_cast<float>(code) * step > value) code--;
+        return static_cast<uint16_t>(code);
+    }
+    
+    // Smallest code that decodes at or above value
+    uint16_t QuantizeUp(float value, float origin, float step) {
+        if (step <= 0.0f) return 0;
+        int code = std::min(std::max(static_cast<int>(ceilf((value - origin) / step)), 0), 65535);
+        while (code < 65535 && origin + static_cast<float>(code) * step < value) code++;
+        return static_cast<uint16_t>(code);
+    }
+    
+    XMVECTOR DecodeLanes(const uint16_t codes[4], FXMVECTOR step, FXMVECTOR origin) {
+        return XMVectorMultiplyAdd(XMLoadUShort4(reinterpret_cast<const XMUSHORT4*>(codes)), step, origin);
+    }
+}
+
+void LinearCullingSystem::PerformFrustumCulling(const Frustum& frustum, ObjectStore& objects) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+    m_stats.Reset();
+    
+    if (m_useQuantized) {
+        UpdateQuantizedBounds(objects);
+        CullQuantizedBounds(frustum);
+        SampleQuantizationError(frustum, objects);
+        
+        m_quantizedStats.culls++;
+        m_quantizedStats.boundsBytes += m_quantizedBlocks.size() * sizeof(QuantizedBoundsBlock);
+        m_quantizedStats.floatBoundsBytes += m_quantizedBlocks.size() * 4 * 6 * sizeof(float);
+    } else {
+        PackBounds(objects);
+        CullPackedBounds(frustum, m_centerX.size());
+    }
+    
+    for (size_t i = 0; i < objects.Size(); ++i) {
+        bool inside = m_outsideMask[i] == 0;
+        objects.visible.Set(i, inside);
+        if (!inside) {
+            m_stats.nodesCulled++;
+            continue;
+        }
+        
+        const ObjectBounds& bounds = objects.bounds[i];
+        if (m_screenSize.IsEnabled() && m_screenSize.IsTooSmall(bounds.minBounds, bounds.maxBounds)) {
+            objects.visible.Reset(i);
+            m_stats.smallRejects++;
+            continue;
+        }
+        
+        // A rotated object's world box can reach into the frustum where the object does not
+        if (objects.HasOrientedBox(i)) {
+            m_stats.orientedTests++;
+            const ObjectOrientedBox& box = objects.orientedBoxes[i];
+            if (!frustum.IsOrientedBoxInFrustum(box.center, box.axes)) {
+                objects.visible.Reset(i);
+                m_stats.orientedRejects++;
+                m_stats.nodesCulled++;
+            }
+        }
+    }
+    
+    m_stats.nodesVisited = static_cast<int>(objects.Size());
+    m_stats.cullTimeMs = std::chrono::duration<float, std::milli>(
+        std::chrono::high_resolution_clock::now() - startTime).count();
+}
+
+void LinearCullingSystem::PackBounds(const ObjectStore& objects) {
+    size_t paddedCount = (objects.Size() + 3) & ~size_t(3);
+    
+    // The quantized path swaps its own results in, so the mask is sized every time
+    m_outsideMask.resize(paddedCount);
+    
+    if (m_packedLayout != objects.GetLayoutVersion() || m_centerX.size() != paddedCount) {
+        m_packedLayout = objects.GetLayoutVersion();
+        
+        // Padding lanes are degenerate boxes at the origin, their results are ignored
+        m_centerX.assign(paddedCount, 0.0f);
+        m_centerY.assign(paddedCount, 0.0f);
+        m_centerZ.assign(paddedCount, 0.0f);
+        m_extentX.assign(paddedCount, 0.0f);
+        m_extentY.assign(paddedCount, 0.0f);
+        m_extentZ.assign(paddedCount, 0.0f);
+        
+        for (size_t i = 0; i < objects.Size(); ++i) {
+            PackObject(objects, i);
+        }
+        return;
+    }
+    
+    // Static bounds only change with the layout; as with the quantized blocks,
+    // every dynamic object is refreshed rather than only those that moved this frame
+    for (size_t i = 0; i < objects.Size(); ++i) {
+        if (objects.dynamic[i]) {
+            PackObject(objects, i);
+        }
+    }
+}
+
+void LinearCullingSystem::PackObject(const ObjectStore& objects, size_t index) {
+    const ObjectBounds& bounds = objects.bounds[index];
+    m_centerX[index] = (bounds.minBounds.x + bounds.maxBounds.x) * 0.5f;
+    m_centerY[index] = (bounds.minBounds.y + bounds.maxBounds.y) * 0.5f;
+    m_centerZ[index] = (bounds.minBounds.z + bounds.maxBounds.z) * 0.5f;
+    m_extentX[index] = (bounds.maxBounds.x - bounds.minBounds.x) * 0.5f;
+    m_extentY[index] = (bounds.maxBounds.y - bounds.minBounds.y) * 0.5f;
+    m_extentZ[index] = (bounds.maxBounds.z - bounds.minBounds.z) * 0.5f;
+}
+
+void LinearCullingSystem::CullPackedBounds(const Frustum& frustum, size_t paddedCount) {
+    // Splat each plane once, then test four objects per iteration
+    PlaneSplats planes(frustum);
+    
+    for (size_t i = 0; i < paddedCount; i += 4) {
+        XMVECTOR cx = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&m_centerX[i]));
+        XMVECTOR cy = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&m_centerY[i]));
+        XMVECTOR cz = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&m_centerZ[i]));
+        XMVECTOR ex = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&m_extentX[i]));
+        XMVECTOR ey = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&m_extentY[i]));
+        XMVECTOR ez = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&m_extentZ[i]));
+        
+        XMStoreInt4(&m_outsideMask[i], planes.TestBoxes(cx, cy, cz, ex, ey, ez));
+    }
+}
+
+void LinearCullingSystem::UpdateQuantizedBounds(const ObjectStore& objects) {
+    size_t blockCount = (objects.Size() + 3) / 4;
+    if (m_quantizedLayout != objects.GetLayoutVersion() || m_quantizedBlocks.size() != blockCount) {
+        m_quantizedLayout = objects.GetLayoutVersion();
+        m_quantizedBlocks.resize(blockCount);
+        for (size_t block = 0; block < blockCount; block++) {
+            EncodeBlock(objects, block);
+        }
+        return;
+    }
+    
+    // Frames can pass without a linear cull, so every dynamic object's block is
+    // refreshed rather than only those that moved this frame
+    for (size_t block = 0; block < blockCount; block++) {
+        size_t end = std::min(block * 4 + 4, objects.Size());
+        for (size_t i = block * 4; i < end; i++) {
+            if (objects.dynamic[i]) {
+                EncodeBlock(objects, block);
+                break;
+            }
+        }
+    }
+}
+
+void LinearCullingSystem::EncodeBlock(const ObjectStore& objects, size_t block) {
+    QuantizedBoundsBlock& encoded = m_quantizedBlocks[block];
+    size_t first = block * 4;
+    size_t count = std::min<size_t>(4, objects.Size() - first);
+    
+    Vector3 blockMin = objects.bounds[first].minBounds;
+    Vector3 blockMax = objects.bounds[first].maxBounds;
+    for (size_t lane = 1; lane < count; lane++) {
+        blockMin = Vector3::Min(blockMin, objects.bounds[first + lane].minBounds);
+        blockMax = Vector3::Max(blockMax, objects.bounds[first + lane].maxBounds);
+    }
+    
+    // One quantum of headroom keeps the block's far edge encodable after rounding up
+    Vector3 step = (blockMax - blockMin) / 65534.0f;
+    encoded.origin = blockMin;
+    encoded.step = step;
+    
+    const float origin[3] = { blockMin.x, blockMin.y, blockMin.z };
+    const float axisStep[3] = { step.x, step.y, step.z };
+    uint16_t* minCodes[3] = { encoded.minX, encoded.minY, encoded.minZ };
+    uint16_t* maxCodes[3] = { encoded.maxX, encoded.maxY, encoded.maxZ };
+    for (size_t lane = 0; lane < 4; lane++) {
+        // Padding lanes decode to a point at the origin, their results are ignored
+        if (lane >= count) {
+            for (int axis = 0; axis < 3; axis++) {
+                minCodes[axis][lane] = 0;
+                maxCodes[axis][lane] = 0;
+            }
+            continue;
+        }
+        
+        const ObjectBounds& bounds = objects.bounds[first + lane];
+        const float minValue[3] = { bounds.minBounds.x, bounds.minBounds.y, bounds.minBounds.z };
+        const float maxValue[3] = { bounds.maxBounds.x, bounds.maxBounds.y, bounds.maxBounds.z };
+        for (int axis = 0; axis < 3; axis++) {
+            minCodes[axis][lane] = QuantizeDown(minValue[axis], origin[axis], axisStep[axis]);
+            maxCodes[axis][lane] = QuantizeUp(maxValue[axis], origin[axis], axisStep[axis]);
+        }
+    }
+    m_quantizedStats.blocksEncoded++;
+}
+
+void LinearCullingSystem::CullQuantizedBounds(const Frustum& frustum) {
+    PlaneSplats planes(frustum);
+    const XMVECTOR half = XMVectorReplicate(0.5f);
+    m_outsideMask.resize(m_quantizedBlocks.size() * 4);
+    
+    for (size_t block = 0; block < m_quantizedBlocks.size(); block++) {
+        const QuantizedBoundsBlock& encoded = m_quantizedBlocks[block];
+        XMVECTOR originX = XMVectorReplicate(encoded.origin.x);
+        XMVECTOR originY = XMVectorReplicate(encoded.origin.y);
+        XMVECTOR originZ = XMVectorReplicate(encoded.origin.z);
+        XMVECTOR stepX = XMVectorReplicate(encoded.step.x);
+        XMVECTOR stepY = XMVectorReplicate(encoded.step.y);
+        XMVECTOR stepZ = XMVectorReplicate(encoded.step.z);
+        
+        // Four boxes per axis: value = origin + code * step
+        XMVECTOR minX = DecodeLanes(encoded.minX, stepX, originX);
+        XMVECTOR minY = DecodeLanes(encoded.minY, stepY, originY);
+        XMVECTOR minZ = DecodeLanes(encoded.minZ, stepZ, originZ);
+        XMVECTOR maxX = DecodeLanes(encoded.maxX, stepX, originX);
+        XMVECTOR maxY = DecodeLanes(encoded.maxY, stepY, originY);
+        XMVECTOR maxZ = DecodeLanes(encoded.maxZ, stepZ, originZ);
+        
+        XMVECTOR cx = XMVectorMultiply(XMVectorAdd(minX, maxX), half);
+        XMVECTOR cy = XMVectorMultiply(XMVectorAdd(minY, maxY), half);
+        XMVECTOR cz = XMVectorMultiply(XMVectorAdd(minZ, maxZ), half);
+        XMVECTOR ex = XMVectorMultiply(XMVectorSubtract(maxX, minX), half);
+        XMVECTOR ey = XMVectorMultiply(XMVectorSubtract(maxY, minY), half);
+        XMVECTOR ez = XMVectorMultiply(XMVectorSubtract(maxZ, minZ), half);
+        
+        XMStoreInt4(&m_outsideMask[block * 4], planes.TestBoxes(cx, cy, cz, ex, ey, ez));
+    }
+}
+
+void LinearCullingSystem::SampleQuantizationError(const Frustum& frustum, const ObjectStore& objects) {
+    if (--m_cullsUntilSample > 0) return;
+    m_cullsUntilSample = Config::QUANTIZED_ERROR_SAMPLE_INTERVAL;
+    
+    // The float pass overwrites the mask, so the quantized results are set aside
+    m_sampleMask.swap(m_outsideMask);
+    PackBounds(objects);
+    CullPackedBounds(frustum, m_centerX.size());
+    
+    for (size_t i = 0; i < objects.Size(); i++) {
+        if (m_sampleMask[i] == 0 && m_outsideMask[i] != 0) {
+            m_quantizedStats.falsePositives++;
+        }
+    }
+    m_quantizedStats.objectsSampled += static_cast<int>(objects.Size());
+    m_outsideMask.swap(m_sampleMask);
+}
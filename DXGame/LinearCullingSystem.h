@@ -0,0 +1,65 @@
+#pragma once
+
+#include "Common.h"
+#include "Structures.h"
+#include "ObjectStore.h"
+
+// ============================================================================
+// LINEAR CULLING SYSTEM CLASS (Brute-force SIMD)
+// ============================================================================
+
+// Four consecutive objects' bounds at 16 bits per axis, relative to the
+// block's own box: 72 bytes where float centers and extents take 96.
+// Decoding rounds every box outward, never inward.
+struct QuantizedBoundsBlock {
+    XMFLOAT3 origin;
+    XMFLOAT3 step;      // World units per quantum
+    uint16_t minX[4], minY[4], minZ[4];
+    uint16_t maxX[4], maxY[4], maxZ[4];
+};
+
+// Streams every object's bounds through a 4-wide plane test. No tree to
+// build or refit, so it wins for small or heavily dynamic scenes.
+class LinearCullingSystem {
+public:
+    LinearCullingSystem() = default;
+    ~LinearCullingSystem() = default;
+
+    void PerformFrustumCulling(const Frustum& frustum, ObjectStore& objects);
+    void SetScreenSizeCulling(const ScreenSizeCullParams& params) { m_screenSize = params; }
+    
+    // Streams persistent 16-bit bounds instead of repacking floats every frame
+    void SetUseQuantizedBounds(bool enable) { m_useQuantized = enable; m_quantizedLayout = ~0u; }
+    bool IsUsingQuantizedBounds() const { return m_useQuantized; }
+    
+    const CullingStats& GetStats() const { return m_stats; }
+    const QuantizedBoundsStats& GetQuantizedStats() const { return m_quantizedStats; }
+    void ResetQuantizedStats() { m_quantizedStats.Reset(); }
+
+private:
+    // Bounds in SoA form (center/extent), padded to a multiple of 4; fully repacked
+    // when the store's layout changes, otherwise only dynamic objects are
+    std::vector<float> m_centerX, m_centerY, m_centerZ;
+    std::vector<float> m_extentX, m_extentY, m_extentZ;
+    uint32_t m_packedLayout = ~0u;
+    std::vector<uint32_t> m_outsideMask;
+    std::vector<uint32_t> m_sampleMask;     // Quantized results, set aside while the float pass runs
+    ScreenSizeCullParams m_screenSize;
+    CullingStats m_stats;
+    
+    // Quantized bounds, re-encoded per block when the store's layout changes or an object moves
+    bool m_useQuantized = false;
+    std::vector<QuantizedBoundsBlock> m_quantizedBlocks;
+    uint32_t m_quantizedLayout = ~0u;
+    int m_cullsUntilSample = 0;
+    QuantizedBoundsStats m_quantizedStats;
+    
+    void PackBounds(const ObjectStore& objects);
+    void PackObject(const ObjectStore& objects, size_t index);
+    void CullPackedBounds(const Frustum& frustum, size_t paddedCount);
+    void UpdateQuantizedBounds(const ObjectStore& objects);
+    void EncodeBlock(const ObjectStore& objects, size_t block);
+    void CullQuantizedBounds(const Frustum& frustum);
+    // Counts quantized-bounds survivors the float bounds would have culled
+    void SampleQuantizationError(const Frustum& frustum, const ObjectStore& objects);
+};
@@ -0,0 +1,274 @@
+#include "ObjectStore.h"
+
+namespace {
+    template <typename T, typename Allocator>
+    void SwapRemove(std::vector<T, Allocator>& values, size_t index) {
+        if (index + 1 != values.size()) {
+            values[index] = values.back();
+        }
+        values.pop_back();
+    }
+
+    template <typename T, typename Allocator>
+    void Gather(std::vector<T, Allocator>& values, const std::vector<uint32_t>& order) {
+        std::vector<T, Allocator> gathered;
+        gathered.reserve(values.size());
+        for (uint32_t from : order) {
+            gathered.push_back(values[from]);
+        }
+        values.swap(gathered);
+    }
+
+    // 10 bits spread to every third bit, as in the GPU BVH's Morton code shader
+    uint32_t ExpandBits(uint32_t v) {
+        v = (v * 0x00010001u) & 0xFF0000FFu;
+        v = (v * 0x00000101u) & 0x0F00F00Fu;
+        v = (v * 0x00000011u) & 0xC30C30C3u;
+        v = (v * 0x00000005u) & 0x49249249u;
+        return v;
+    }
+}
+
+// ============================================================================
+// OBJECT STORE IMPLEMENTATION
+// ============================================================================
+
+ObjectHandle ObjectStore::Add(const RenderObject& object) {
+    size_t index = Size();
+
+    // Freed slots are reused with their bumped generation
+    uint32_t slot;
+    if (!m_freeSlots.empty()) {
+        slot = m_freeSlots.back();
+        m_freeSlots.pop_back();
+        m_slotIndex[slot] = static_cast<uint32_t>(index);
+    } else {
+        slot = static_cast<uint32_t>(m_slotIndex.size());
+        m_slotIndex.push_back(static_cast<uint32_t>(index));
+        m_slotGeneration.push_back(0);
+    }
+    m_indexSlot.push_back(slot);
+    m_layoutVersion++;
+
+    bounds.emplace_back();
+    spheres.emplace_back();
+    visible.PushBack(true);
+    dynamic.push_back(object.isDynamic ? 1 : 0);
+    ObjectTransform transform;
+    transform.position = object.position;
+    transform.scale = object.scale;
+    transforms.push_back(transform);
+    rotations.push_back(object.rotation);
+
+    ObjectShape shape;
+    shape.localCenter = (object.localMin + object.localMax) * 0.5f;
+    shape.localHalfSize = (object.localMax - object.localMin) * 0.5f;
+    shape.occluderHalfSize = object.occluderHalfSize;
+    shapes.push_back(shape);
+
+    ObjectMotion objectMotion;
+    objectMotion.previousPosition = GetPosition(index);
+    objectMotion.animationTime = object.animationTime;
+    objectMotion.animationCenter = object.animationCenter;
+    objectMotion.animationRadius = object.animationRadius;
+    motion.push_back(objectMotion);
+
+    queries.emplace_back();
+    if (Config::KEEP_ORIENTED_BOUNDS) {
+        orientedBoxes.emplace_back();
+    }
+
+    UpdateBounds(index);
+    return GetHandle(index);
+}
+
+bool ObjectStore::Remove(ObjectHandle handle, ObjectRemoval& outRemoval) {
+    int index = IndexOf(handle);
+    if (index < 0) return false;
+
+    size_t last = Size() - 1;
+    SwapRemove(bounds, index);
+    SwapRemove(spheres, index);
+    visible.SwapRemove(index);
+    SwapRemove(dynamic, index);
+    SwapRemove(transforms, index);
+    SwapRemove(rotations, index);
+    SwapRemove(shapes, index);
+    SwapRemove(motion, index);
+    SwapRemove(queries, index);
+    if (!orientedBoxes.empty()) {
+        SwapRemove(orientedBoxes, index);
+    }
+    SwapRemove(m_indexSlot, index);
+
+    if (static_cast<size_t>(index) != last) {
+        m_slotIndex[m_indexSlot[index]] = static_cast<uint32_t>(index);
+    }
+    m_slotGeneration[handle.slot]++;
+    m_freeSlots.push_back(handle.slot);
+    m_layoutVersion++;
+
+    outRemoval.index = index;
+    outRemoval.movedFrom = static_cast<int>(last);
+    return true;
+}
+
+void ObjectStore::Reserve(size_t count) {
+    bounds.reserve(count);
+    spheres.reserve(count);
+    visible.Reserve(count);
+    dynamic.reserve(count);
+    transforms.reserve(count);
+    rotations.reserve(count);
+    shapes.reserve(count);
+    motion.reserve(count);
+    queries.reserve(count);
+    if (Config::KEEP_ORIENTED_BOUNDS) {
+        orientedBoxes.reserve(count);
+    }
+    m_indexSlot.reserve(count);
+}
+
+void ObjectStore::Clear() {
+    bounds.clear();
+    spheres.clear();
+    visible.Clear();
+    dynamic.clear();
+    transforms.clear();
+    rotations.clear();
+    shapes.clear();
+    motion.clear();
+    queries.clear();
+    orientedBoxes.clear();
+
+    for (uint32_t slot : m_indexSlot) {
+        m_slotGeneration[slot]++;
+        m_freeSlots.push_back(slot);
+    }
+    m_indexSlot.clear();
+    m_layoutVersion++;
+}
+
+void ObjectStore::Reorder(const std::vector<uint32_t>& order, ObjectReorder& outReorder) {
+    outReorder.newIndex.assign(Size(), -1);
+    for (size_t i = 0; i < order.size(); i++) {
+        outReorder.newIndex[order[i]] = static_cast<int>(i);
+    }
+
+    Gather(bounds, order);
+    Gather(spheres, order);
+    VisibilitySet gatheredVisible(order.size());
+    for (size_t i = 0; i < order.size(); i++) {
+        gatheredVisible.Set(i, visible.Test(order[i]));
+    }
+    std::swap(visible, gatheredVisible);
+    Gather(dynamic, order);
+    Gather(transforms, order);
+    Gather(rotations, order);
+    Gather(shapes, order);
+    Gather(motion, order);
+    Gather(queries, order);
+    if (!orientedBoxes.empty()) {
+        Gather(orientedBoxes, order);
+    }
+
+    // Slots keep their generations, so outstanding handles now resolve to the new indices
+    Gather(m_indexSlot, order);
+    for (size_t i = 0; i < m_indexSlot.size(); i++) {
+        m_slotIndex[m_indexSlot[i]] = static_cast<uint32_t>(i);
+    }
+    m_layoutVersion++;
+}
+
+void ObjectStore::GetMortonOrder(std::vector<uint32_t>& outOrder) const {
+    outOrder.clear();
+    if (Empty()) return;
+
+    Vector3 sceneMin = (bounds[0].minBounds + bounds[0].maxBounds) * 0.5f;
+    Vector3 sceneMax = sceneMin;
+    for (const ObjectBounds& box : bounds) {
+        Vector3 center = (box.minBounds + box.maxBounds) * 0.5f;
+        sceneMin = Vector3::Min(sceneMin, center);
+        sceneMax = Vector3::Max(sceneMax, center);
+    }
+    Vector3 extent = sceneMax - sceneMin;
+    Vector3 scale(extent.x > 0.0f ? 1023.0f / extent.x : 0.0f, extent.y > 0.0f ? 1023.0f / extent.y : 0.0f,
+                  extent.z > 0.0f ? 1023.0f / extent.z : 0.0f);
+
+    // Code in the high half, index in the low half: one sort orders both
+    std::vector<uint64_t> keys(Size());
+    for (size_t i = 0; i < Size(); i++) {
+        Vector3 cell = ((bounds[i].minBounds + bounds[i].maxBounds) * 0.5f - sceneMin) * scale;
+        uint32_t code = ExpandBits(static_cast<uint32_t>(cell.x)) * 4 + ExpandBits(static_cast<uint32_t>(cell.y)) * 2 +
+                        ExpandBits(static_cast<uint32_t>(cell.z));
+        keys[i] = (static_cast<uint64_t>(code) << 32) | i;
+    }
+    std::sort(keys.begin(), keys.end());
+
+    outOrder.resize(keys.size());
+    for (size_t i = 0; i < keys.size(); i++) {
+        outOrder[i] = static_cast<uint32_t>(keys[i]);
+    }
+}
+
+Matrix ObjectStore::GetWorldMatrix(size_t index) const {
+    const ObjectTransform& transform = transforms[index];
+    Matrix world = Matrix::CreateScale(transform.scale);
+    if (IsRotated(index)) {
+        world = world * Matrix::CreateFromQuaternion(rotations[index]);
+    }
+    world.Translation(transform.position);
+    return world;
+}
+
+void ObjectStore::UpdateBounds(size_t index) {
+    uint32_t single = static_cast<uint32_t>(index);
+    UpdateBounds(&single, 1);
+}
+
+void ObjectStore::UpdateBounds(const uint32_t* indices, size_t count) {
+    const bool keepOriented = !orientedBoxes.empty();
+
+    for (size_t n = 0; n < count; n++) {
+        size_t index = indices[n];
+        const ObjectTransform& transform = transforms[index];
+        const ObjectShape& shape = shapes[index];
+
+        // Scale applies first, so the mesh-space box scales as a box
+        XMVECTOR scale = XMLoadFloat3(&transform.scale);
+        XMVECTOR center = XMVectorMultiply(XMLoadFloat3(&shape.localCenter), scale);
+        XMVECTOR extent = XMVectorMultiply(XMLoadFloat3(&shape.localHalfSize), XMVectorAbs(scale));
+        XMVECTOR position = XMLoadFloat3(&transform.position);
+        float radius = XMVectorGetX(XMVector3Length(extent));
+
+        XMVECTOR axisX, axisY, axisZ;
+        if (IsRotated(index)) {
+            // Arvo: the world box's extent along each axis sums the absolute
+            // contributions of the rotated local half-axes
+            XMMATRIX rotation = XMMatrixRotationQuaternion(XMLoadFloat4(&rotations[index]));
+            axisX = XMVectorMultiply(rotation.r[0], XMVectorSplatX(extent));
+            axisY = XMVectorMultiply(rotation.r[1], XMVectorSplatY(extent));
+            axisZ = XMVectorMultiply(rotation.r[2], XMVectorSplatZ(extent));
+            center = XMVectorAdd(XMVector3TransformNormal(center, rotation), position);
+            extent = XMVectorAdd(XMVectorAdd(XMVectorAbs(axisX), XMVectorAbs(axisY)), XMVectorAbs(axisZ));
+        } else {
+            center = XMVectorAdd(center, position);
+            axisX = XMVectorAndInt(extent, g_XMMaskX);
+            axisY = XMVectorAndInt(extent, g_XMMaskY);
+            axisZ = XMVectorAndInt(extent, g_XMMaskZ);
+        }
+
+        XMStoreFloat3(&bounds[index].minBounds, XMVectorSubtract(center, extent));
+        XMStoreFloat3(&bounds[index].maxBounds, XMVectorAdd(center, extent));
+        XMStoreFloat3(&spheres[index].center, center);
+        spheres[index].radius = radius;
+
+        if (keepOriented) {
+            ObjectOrientedBox& box = orientedBoxes[index];
+            XMStoreFloat3(&box.center, center);
+            XMStoreFloat3(&box.axes[0], axisX);
+            XMStoreFloat3(&box.axes[1], axisY);
+            XMStoreFloat3(&box.axes[2], axisZ);
+        }
+    }
+}
@@ -0,0 +1,172 @@
+#pragma once
+
+#include "Common.h"
+#include "Structures.h"
+#include "AlignedAllocator.h"
+#include "VisibilitySet.h"
+
+// ============================================================================
+// OBJECT STORE (structure of arrays)
+// ============================================================================
+
+// World-space box, the one thing every culling loop reads
+struct ObjectBounds {
+    Vector3 minBounds;
+    Vector3 maxBounds;
+};
+
+struct ObjectSphere {
+    Vector3 center;
+    float radius = -1.0f;   // Negative when absent
+};
+
+// Placement without rotation, 24 bytes where a world matrix takes 64. Animation and
+// bounds only need these; the matrix is built at draw time for visible objects.
+struct ObjectTransform {
+    Vector3 position = Vector3::Zero;
+    Vector3 scale = Vector3(1.0f, 1.0f, 1.0f);
+};
+
+// World-space box along the object's own axes, tighter than its world box once rotated
+struct ObjectOrientedBox {
+    Vector3 center;
+    Vector3 axes[3];    // Local axes scaled by the half extents
+};
+
+// Mesh-space box of the drawn mesh and the solid box inside it used as an occluder
+struct ObjectShape {
+    Vector3 localCenter = Vector3::Zero;
+    Vector3 localHalfSize = Vector3(0.5f, 0.5f, 0.5f);
+    Vector3 occluderHalfSize = Vector3::Zero;   // Zero if not an occluder
+};
+
+// Animation state, only touched for dynamic objects
+struct ObjectMotion {
+    Vector3 velocity = Vector3::Zero;
+    Vector3 previousPosition = Vector3::Zero;
+    float movementDistance = 0.0f;              // Moved this frame
+    float animationTime = 0.0f;
+    Vector3 animationCenter = Vector3::Zero;
+    float animationRadius = 0.0f;
+};
+
+// Per-object hardware occlusion query bookkeeping
+struct ObjectQueryState {
+    UINT64 lastQueryResult = 0;
+    int occludedFrameCount = 0;     // Consecutive occluded results
+    int queryInterval = 1;          // Frames between queries, grows while the result is stable
+    int nextQueryFrame = 0;
+    bool queryInProgress = false;   // Has an entry in the in-flight query ring
+    bool queryHidden = false;       // In view but hidden by its last query, re-tested depth-only
+};
+
+// Stable reference to an object. Dense indices shift when another object is
+// swap-removed; a handle keeps resolving to its object until that object is
+// removed, then the slot's generation moves on and the handle resolves to nothing.
+struct ObjectHandle {
+    uint32_t slot = 0xFFFFFFFFu;
+    uint32_t generation = 0;
+
+    bool operator==(const ObjectHandle& other) const { return slot == other.slot && generation == other.generation; }
+    bool operator!=(const ObjectHandle& other) const { return !(*this == other); }
+};
+
+// What a swap-remove did to the dense indices: the object at index is gone and
+// the former last object, at movedFrom, now lives at index. Systems keeping
+// per-index state replay this. movedFrom == index when the last object was removed.
+struct ObjectRemoval {
+    int index = -1;
+    int movedFrom = -1;
+};
+
+// What a reorder did to the dense indices: the object that was at index i now
+// lives at newIndex[i]. Systems keeping per-index state relabel with this.
+struct ObjectReorder {
+    std::vector<int> newIndex;
+};
+
+// Every object's data, one cache-line-aligned array per access pattern. Culling
+// streams bounds and spheres and writes visibility; animation touches motion and
+// transforms; per-object queries their own state. Rotations sit apart from the
+// transforms since most objects never rotate. A loop only pulls the bytes it
+// uses through the cache instead of whole ~150-byte objects. Index i in every
+// array is the same object, and the arrays stay dense: removal moves the last
+// object into the hole, so code holding on to an object keeps a handle.
+struct ObjectStore {
+    AlignedVector<ObjectBounds> bounds;
+    AlignedVector<ObjectSphere> spheres;
+    VisibilitySet visible;
+    AlignedVector<uint8_t> dynamic;
+    AlignedVector<ObjectTransform> transforms;
+    AlignedVector<Quaternion> rotations;
+    AlignedVector<ObjectShape> shapes;
+    AlignedVector<ObjectMotion> motion;
+    AlignedVector<ObjectQueryState> queries;
+    AlignedVector<ObjectOrientedBox> orientedBoxes;   // Empty unless Config::KEEP_ORIENTED_BOUNDS
+
+    // Appends an object laid out from its description; it gets index Size() - 1
+    ObjectHandle Add(const RenderObject& object);
+    // Swap-remove. False for a handle whose object is already gone
+    bool Remove(ObjectHandle handle, ObjectRemoval& outRemoval);
+    void Reserve(size_t count);
+    // Every outstanding handle goes stale
+    void Clear();
+    // Moves the object at order[i] to index i in every array; handles follow their objects
+    void Reorder(const std::vector<uint32_t>& order, ObjectReorder& outReorder);
+    // Indices along a Morton curve through the world box centers, spatial neighbours mostly adjacent
+    void GetMortonOrder(std::vector<uint32_t>& outOrder) const;
+
+    // -1 when the handle's object was removed
+    int IndexOf(ObjectHandle handle) const {
+        if (handle.slot >= m_slotIndex.size() || m_slotGeneration[handle.slot] != handle.generation) return -1;
+        return static_cast<int>(m_slotIndex[handle.slot]);
+    }
+    ObjectHandle GetHandle(size_t index) const {
+        ObjectHandle handle;
+        handle.slot = m_indexSlot[index];
+        handle.generation = m_slotGeneration[handle.slot];
+        return handle;
+    }
+    // Changes whenever objects are added, removed or reordered, so index-keyed caches know to resync
+    uint32_t GetLayoutVersion() const { return m_layoutVersion; }
+
+    size_t Size() const { return bounds.size(); }
+    bool Empty() const { return bounds.empty(); }
+
+    const Vector3& GetPosition(size_t index) const { return transforms[index].position; }
+    bool IsRotated(size_t index) const { return rotations[index] != Quaternion::Identity; }
+
+    // Scale, rotation, translation
+    Matrix GetWorldMatrix(size_t index) const;
+
+    // World box, sphere and oriented box from the transform and the mesh-space box
+    void UpdateBounds(size_t index);
+    // Same for a batch, e.g. every object that moved this frame
+    void UpdateBounds(const uint32_t* indices, size_t count);
+
+    // Rotated objects are the only ones whose oriented box is tighter than their world box
+    bool HasOrientedBox(size_t index) const { return !orientedBoxes.empty() && IsRotated(index); }
+
+    bool HasMoved(size_t index) const {
+        return dynamic[index] && motion[index].movementDistance > 0.0f;
+    }
+
+    // A rotated mesh does not contain its axis-aligned occluder box, so it never occludes
+    bool IsOccluder(size_t index) const {
+        const Vector3& halfSize = shapes[index].occluderHalfSize;
+        return halfSize.x > 0.0f && halfSize.y > 0.0f && halfSize.z > 0.0f && !IsRotated(index);
+    }
+
+    void GetOccluderBounds(size_t index, Vector3& outMin, Vector3& outMax) const {
+        Vector3 position = GetPosition(index);
+        outMin = position - shapes[index].occluderHalfSize;
+        outMax = position + shapes[index].occluderHalfSize;
+    }
+
+private:
+    AlignedVector<uint32_t> m_indexSlot;    // Dense index -> slot
+    std::vector<uint32_t> m_slotIndex;      // Slot -> dense index, while the slot is live
+    std::vector<uint32_t> m_slotGeneration;
+    std::vector<uint32_t> m_freeSlots;
+    uint32_t m_layoutVersion = 0;
+};
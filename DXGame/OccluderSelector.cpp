@@ -0,0 +1,120 @@
+#include "OccluderSelector.h"
+
+void OccluderSelector::SelectOccluders(const ObjectStore& objects, const Matrix& viewProjection,
+                                       float width, float height, const Vector3& cameraPosition, const Frustum* frustum,
+                                       const VisibilitySet* candidateMask) {
+    UpdateStickiness(objects.Size());
+
+    m_candidates.clear();
+    for (int i = 0; i < static_cast<int>(objects.Size()); ++i) {
+        if (!objects.IsOccluder(i)) continue;
+        if (candidateMask && (i >= static_cast<int>(candidateMask->Size()) || !candidateMask->Test(i))) continue;
+
+        const ObjectBounds& objectBounds = objects.bounds[i];
+        bool inView = frustum ? frustum->IsBoxInFrustum(objectBounds.minBounds, objectBounds.maxBounds) :
+                                objects.visible.Test(i);
+        if (!inView) continue;
+
+        Vector3 occluderMin, occluderMax;
+        objects.GetOccluderBounds(i, occluderMin, occluderMax);
+
+        // Occluders crossing the near plane are not rasterized, so they are not candidates
+        ScreenBounds bounds;
+        if (!bounds.FromBox(viewProjection, width, height, occluderMin, occluderMax)) continue;
+
+        float clampedWidth = std::min(bounds.maxX, width) - std::max(bounds.minX, 0.0f);
+        float clampedHeight = std::min(bounds.maxY, height) - std::max(bounds.minY, 0.0f);
+        if (clampedWidth <= 0.0f || clampedHeight <= 0.0f) continue;
+
+        float area = clampedWidth * clampedHeight;
+        if (area < Config::OCCLUDER_MIN_SCREEN_AREA) continue;
+
+        // Near occluders hide more of the scene behind them than their area alone suggests
+        float distance = std::max((objects.GetPosition(i) - cameraPosition).Length(), 1e-3f);
+        float score = area / distance;
+        if (m_contributedLastFrame[i]) {
+            score *= 1.0f + Config::OCCLUDER_STICKINESS;
+        }
+
+        // A box costs two triangles per face turned towards the camera
+        int frontFaces = (cameraPosition.x < occluderMin.x || cameraPosition.x > occluderMax.x ? 1 : 0) +
+                         (cameraPosition.y < occluderMin.y || cameraPosition.y > occluderMax.y ? 1 : 0) +
+                         (cameraPosition.z < occluderMin.z || cameraPosition.z > occluderMax.z ? 1 : 0);
+
+        m_candidates.push_back({ score, i, frontFaces * 2, static_cast<int>(area) });
+    }
+    m_candidateCount = static_cast<int>(m_candidates.size());
+
+    std::sort(m_candidates.begin(), m_candidates.end());
+
+    // Greedy top-K: skip candidates that would overflow a budget, smaller ones may still fit
+    m_selection.clear();
+    m_trianglesUsed = 0;
+    m_pixelsUsed = 0;
+    for (const auto& candidate : m_candidates) {
+        if (static_cast<int>(m_selection.size()) >= m_maxOccluders) break;
+
+        bool fits = m_trianglesUsed + candidate.triangles <= m_triangleBudget &&
+                    m_pixelsUsed + candidate.pixels <= m_pixelBudget;
+        if (!fits && !m_selection.empty()) continue;
+
+        OccluderContribution selected;
+        selected.objectIndex = candidate.objectIndex;
+        selected.score = candidate.score;
+        selected.pixelEstimate = candidate.pixels;
+        m_selection.push_back(selected);
+
+        m_trianglesUsed += candidate.triangles;
+        m_pixelsUsed += candidate.pixels;
+    }
+}
+
+void OccluderSelector::SetBudgets(int maxOccluders, int triangleBudget, int pixelBudget) {
+    m_maxOccluders = std::max(maxOccluders, 1);
+    m_triangleBudget = std::max(triangleBudget, 0);
+    m_pixelBudget = std::max(pixelBudget, 0);
+}
+
+void OccluderSelector::RecordPixelsOwned(int slot, int pixels) {
+    if (slot >= 0 && slot < static_cast<int>(m_selection.size())) {
+        m_selection[slot].pixelsOwned += pixels;
+    }
+}
+
+void OccluderSelector::RecordOccludedObject(int slot) {
+    if (slot >= 0 && slot < static_cast<int>(m_selection.size())) {
+        m_selection[slot].objectsOccluded++;
+    }
+}
+
+void OccluderSelector::RemoveObject(const ObjectRemoval& removal) {
+    for (auto& selected : m_selection) {
+        if (selected.objectIndex == removal.index) {
+            selected.objectIndex = -1;
+            selected.pixelsOwned = 0;
+        } else if (selected.objectIndex == removal.movedFrom) {
+            selected.objectIndex = removal.index;
+        }
+    }
+}
+
+void OccluderSelector::RemapObjects(const ObjectReorder& reorder) {
+    for (auto& selected : m_selection) {
+        if (selected.objectIndex >= 0 && selected.objectIndex < static_cast<int>(reorder.newIndex.size())) {
+            selected.objectIndex = reorder.newIndex[selected.objectIndex];
+        }
+    }
+}
+
+void OccluderSelector::UpdateStickiness(size_t objectCount) {
+    // Only occluders that still owned depth pixels keep their bonus
+    m_contributedLastFrame.assign(objectCount, 0);
+    // Sized to the scene, so turning towards more occluders does not allocate mid-frame
+    m_candidates.reserve(objectCount);
+    m_selection.reserve(std::min(objectCount, static_cast<size_t>(m_maxOccluders)));
+    for (const auto& selected : m_selection) {
+        if (selected.pixelsOwned > 0 && selected.objectIndex < static_cast<int>(objectCount)) {
+            m_contributedLastFrame[selected.objectIndex] = 1;
+        }
+    }
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "Common.h"
+#include "Structures.h"
+#include "ObjectStore.h"
+
+// ============================================================================
+// OCCLUDER SELECTOR CLASS
+// ============================================================================
+
+// What one selected occluder did this frame, for tuning the budgets
+struct OccluderContribution {
+    int objectIndex = -1;
+    float score = 0.0f;
+    int pixelEstimate = 0;      // Projected rectangle area used against the pixel budget
+    int pixelsOwned = 0;        // Depth-buffer pixels where it is the nearest occluder
+    int objectsOccluded = 0;    // Occluded objects credited to it
+};
+
+// Ranks candidate occluders by projected area over distance, with a bonus for
+// occluders that contributed last frame (temporal stickiness, fewer pops), and
+// keeps the best ones that fit the occluder count, triangle and pixel budgets.
+class OccluderSelector {
+public:
+    OccluderSelector() = default;
+    ~OccluderSelector() = default;
+
+    // Candidates are occluders marked visible, or passing the frustum when one is given,
+    // optionally restricted to objects whose candidateMask entry is set
+    void SelectOccluders(const ObjectStore& objects, const Matrix& viewProjection,
+                         float width, float height, const Vector3& cameraPosition, const Frustum* frustum,
+                         const VisibilitySet* candidateMask = nullptr);
+
+    // Budgets - at least one occluder is always kept, however large
+    void SetBudgets(int maxOccluders, int triangleBudget, int pixelBudget);
+
+    // Contribution feedback, by slot in the current selection
+    void RecordPixelsOwned(int slot, int pixels);
+    void RecordOccludedObject(int slot);
+
+    // Last frame's selection follows the store's swap-remove, so its bonus survives
+    void RemoveObject(const ObjectRemoval& removal);
+    void RemapObjects(const ObjectReorder& reorder);
+
+    // State queries
+    const std::vector<OccluderContribution>& GetSelection() const { return m_selection; }
+    int GetCandidateCount() const { return m_candidateCount; }
+    int GetTrianglesUsed() const { return m_trianglesUsed; }
+    int GetPixelsUsed() const { return m_pixelsUsed; }
+    int GetTriangleBudget() const { return m_triangleBudget; }
+    int GetPixelBudget() const { return m_pixelBudget; }
+
+private:
+    struct Candidate {
+        float score;
+        int objectIndex;
+        int triangles;
+        int pixels;
+        bool operator<(const Candidate& other) const { return score > other.score; }
+    };
+
+    int m_maxOccluders = Config::MAX_SW_OCCLUDERS;
+    int m_triangleBudget = Config::OCCLUDER_TRIANGLE_BUDGET;
+    int m_pixelBudget = Config::OCCLUDER_PIXEL_BUDGET;
+
+    std::vector<Candidate> m_candidates;
+    std::vector<OccluderContribution> m_selection;
+    std::vector<uint8_t> m_contributedLastFrame;   // Per object index
+    int m_candidateCount = 0;
+    int m_trianglesUsed = 0;
+    int m_pixelsUsed = 0;
+
+    void UpdateStickiness(size_t objectCount);
+};
@@ -0,0 +1,171 @@
+#include "OcclusionQueryBackend.h"
+#include "SoftwareOcclusionCuller.h"
+
+// ============================================================================
+// D3D11 OCCLUSION QUERY BACKEND
+// ============================================================================
+
+bool D3DOcclusionQueryBackend::Initialize(ComPtr<ID3D11Device> device, ComPtr<ID3D11DeviceContext> context,
+                                          CommonStates* states) {
+    m_device = device;
+    m_context = context;
+    m_states = states;
+    if (!m_device || !m_context || !m_states) return false;
+
+    // Proxies only test depth: no colour, no depth writes
+    D3D11_BLEND_DESC blendDesc = {};
+    blendDesc.RenderTarget[0].BlendEnable = FALSE;
+    blendDesc.RenderTarget[0].RenderTargetWriteMask = 0;
+    HRESULT hr = m_device->CreateBlendState(&blendDesc, &m_noColorWrites);
+    if (FAILED(hr)) {
+        OutputDebugStringA("Failed to create occlusion proxy blend state\n");
+        return false;
+    }
+
+    m_proxyCube = GeometricPrimitive::CreateCube(m_context.Get());
+    return true;
+}
+
+void D3DOcclusionQueryBackend::SetCamera(const Matrix& view, const Matrix& projection) {
+    m_view = view;
+    m_projection = projection;
+}
+
+OcclusionQueryHandle D3DOcclusionQueryBackend::BeginQuery() {
+    OcclusionQueryHandle handle = INVALID_OCCLUSION_QUERY;
+    if (!m_freeQueries.empty()) {
+        handle = m_freeQueries.back();
+        m_freeQueries.pop_back();
+    } else {
+        D3D11_QUERY_DESC queryDesc = {};
+        queryDesc.Query = D3D11_QUERY_OCCLUSION;
+
+        ComPtr<ID3D11Query> query;
+        HRESULT hr = m_device->CreateQuery(&queryDesc, &query);
+        if (FAILED(hr)) {
+            OutputDebugStringA("Failed to create occlusion query\n");
+            return INVALID_OCCLUSION_QUERY;
+        }
+        m_queries.push_back(query);
+        m_freeQueries.reserve(m_queries.size());    // Releasing them all later must not allocate
+        handle = static_cast<OcclusionQueryHandle>(m_queries.size() - 1);
+    }
+
+    m_context->Begin(m_queries[handle].Get());
+    return handle;
+}
+
+void D3DOcclusionQueryBackend::DrawBox(const QueryBox& box) {
+    // Both sides of the proxy are drawn, so a box the camera looks into still gets samples
+    auto proxyState = [this]() {
+        m_context->OMSetBlendState(m_noColorWrites.Get(), nullptr, 0xFFFFFFFF);
+        m_context->OMSetDepthStencilState(m_states->DepthRead(), 0);
+        m_context->RSSetState(m_states->CullNone());
+    };
+
+    Vector3 center = (box.minBounds + box.maxBounds) * 0.5f;
+    Vector3 size = Vector3::Max(box.maxBounds - box.minBounds, Vector3(1e-3f, 1e-3f, 1e-3f));
+    Matrix world = Matrix::CreateScale(size) * Matrix::CreateTranslation(center);
+    m_proxyCube->Draw(world, m_view, m_projection, Colors::White, nullptr, false, proxyState);
+}
+
+void D3DOcclusionQueryBackend::EndQuery(OcclusionQueryHandle query) {
+    if (query >= 0 && query < static_cast<int>(m_queries.size())) {
+        m_context->End(m_queries[query].Get());
+    }
+}
+
+bool D3DOcclusionQueryBackend::GetResult(OcclusionQueryHandle query, UINT64& samples) {
+    if (query < 0 || query >= static_cast<int>(m_queries.size())) return false;
+
+    HRESULT hr = m_context->GetData(m_queries[query].Get(), &samples, sizeof(samples), D3D11_ASYNC_GETDATA_DONOTFLUSH);
+    return hr == S_OK;
+}
+
+void D3DOcclusionQueryBackend::ReleaseQuery(OcclusionQueryHandle query) {
+    if (query >= 0 && query < static_cast<int>(m_queries.size())) {
+        m_freeQueries.push_back(query);
+    }
+}
+
+// ============================================================================
+// SOFTWARE OCCLUSION QUERY BACKEND
+// ============================================================================
+
+SoftwareOcclusionQueryBackend::SoftwareOcclusionQueryBackend(const SoftwareOcclusionCuller& depthSource, int latencyFrames)
+    : m_depthSource(depthSource)
+    , m_latencyFrames(std::max(latencyFrames, 0)) {
+}
+
+OcclusionQueryHandle SoftwareOcclusionQueryBackend::BeginQuery() {
+    OcclusionQueryHandle handle = INVALID_OCCLUSION_QUERY;
+    if (!m_freeQueries.empty()) {
+        handle = m_freeQueries.back();
+        m_freeQueries.pop_back();
+    } else {
+        m_queries.emplace_back();
+        m_freeQueries.reserve(m_queries.size());
+        handle = static_cast<OcclusionQueryHandle>(m_queries.size() - 1);
+    }
+
+    m_queries[handle].samples = 0;
+    m_openQuery = handle;
+    return handle;
+}
+
+void SoftwareOcclusionQueryBackend::DrawBox(const QueryBox& box) {
+    // The depth buffer is read now; only the answer is delayed
+    if (m_openQuery != INVALID_OCCLUSION_QUERY) {
+        m_queries[m_openQuery].samples += CountVisibleSamples(box);
+    }
+}
+
+void SoftwareOcclusionQueryBackend::EndQuery(OcclusionQueryHandle query) {
+    if (query >= 0 && query < static_cast<int>(m_queries.size())) {
+        m_queries[query].readyFrame = m_frame + m_latencyFrames;
+    }
+    m_openQuery = INVALID_OCCLUSION_QUERY;
+}
+
+bool SoftwareOcclusionQueryBackend::GetResult(OcclusionQueryHandle query, UINT64& samples) {
+    if (query < 0 || query >= static_cast<int>(m_queries.size())) return false;
+    if (m_frame < m_queries[query].readyFrame) return false;
+
+    samples = m_queries[query].samples;
+    return true;
+}
+
+void SoftwareOcclusionQueryBackend::ReleaseQuery(OcclusionQueryHandle query) {
+    if (query >= 0 && query < static_cast<int>(m_queries.size())) {
+        m_freeQueries.push_back(query);
+    }
+}
+
+UINT64 SoftwareOcclusionQueryBackend::CountVisibleSamples(const QueryBox& box) const {
+    int width = m_depthSource.GetWidth();
+    int height = m_depthSource.GetHeight();
+
+    ScreenBounds bounds;
+    if (!bounds.FromBox(m_viewProjection, static_cast<float>(width), static_cast<float>(height),
+                        box.minBounds, box.maxBounds)) {
+        return 1; // Touches the near plane, it covers the camera
+    }
+
+    int x0 = std::max(static_cast<int>(floorf(bounds.minX)), 0);
+    int x1 = std::min(static_cast<int>(floorf(bounds.maxX)), width - 1);
+    int y0 = std::max(static_cast<int>(floorf(bounds.minY)), 0);
+    int y1 = std::min(static_cast<int>(floorf(bounds.maxY)), height - 1);
+
+    // Same rule as the culler's own test: a pixel passes unless something is strictly nearer
+    const std::vector<float>& depth = m_depthSource.GetDepthBuffer();
+    UINT64 samples = 0;
+    for (int y = y0; y <= y1; y++) {
+        const float* row = &depth[static_cast<size_t>(y) * width];
+        for (int x = x0; x <= x1; x++) {
+            if (row[x] >= bounds.nearestDepth) {
+                samples++;
+            }
+        }
+    }
+    return samples;
+}
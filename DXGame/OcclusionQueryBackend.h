@@ -0,0 +1,133 @@
+#pragma once
+
+#include "Common.h"
+#include "Structures.h"
+
+class SoftwareOcclusionCuller;
+
+// ============================================================================
+// OCCLUSION QUERY BACKEND INTERFACE
+// ============================================================================
+
+using OcclusionQueryHandle = int;
+constexpr OcclusionQueryHandle INVALID_OCCLUSION_QUERY = -1;
+
+struct QueryBox {
+    Vector3 minBounds;
+    Vector3 maxBounds;
+};
+
+// Where occlusion queries are answered. A query draws the proxy boxes against
+// the current depth buffer without writing it; its result is the number of
+// samples that passed. Results may arrive frames later, as on a GPU.
+// Handles come from a pool that grows to the number in flight and are
+// returned with ReleaseQuery once their result has been read.
+class IOcclusionQueryBackend {
+public:
+    virtual ~IOcclusionQueryBackend() = default;
+
+    // Called once per frame before results are read back
+    virtual void BeginFrame() {}
+    virtual void SetCamera(const Matrix& view, const Matrix& projection) = 0;
+
+    // Opens a query from the pool. Anything drawn before EndQuery counts - on the
+    // D3D11 backend that includes the caller's own geometry.
+    virtual OcclusionQueryHandle BeginQuery() = 0;
+    virtual void DrawBox(const QueryBox& box) = 0;
+    virtual void EndQuery(OcclusionQueryHandle query) = 0;
+    // False while the result is not ready yet
+    virtual bool GetResult(OcclusionQueryHandle query, UINT64& samples) = 0;
+    virtual void ReleaseQuery(OcclusionQueryHandle query) = 0;
+
+    // Queries ever created, in flight or free
+    virtual int GetPoolSize() const = 0;
+
+    // One query covering every box - a multi-query when count > 1
+    OcclusionQueryHandle IssueQuery(const QueryBox* boxes, int count) {
+        OcclusionQueryHandle query = BeginQuery();
+        if (query == INVALID_OCCLUSION_QUERY) return query;
+        for (int i = 0; i < count; i++) {
+            DrawBox(boxes[i]);
+        }
+        EndQuery(query);
+        return query;
+    }
+};
+
+// ============================================================================
+// D3D11 OCCLUSION QUERY BACKEND
+// ============================================================================
+
+// Hardware queries on depth-tested, colour- and depth-write-free proxy cubes.
+// Queries are recycled through a free list, so only as many exist as are in flight.
+class D3DOcclusionQueryBackend : public IOcclusionQueryBackend {
+public:
+    D3DOcclusionQueryBackend() = default;
+    ~D3DOcclusionQueryBackend() = default;
+
+    bool Initialize(ComPtr<ID3D11Device> device, ComPtr<ID3D11DeviceContext> context, CommonStates* states);
+
+    void SetCamera(const Matrix& view, const Matrix& projection) override;
+    OcclusionQueryHandle BeginQuery() override;
+    void DrawBox(const QueryBox& box) override;
+    void EndQuery(OcclusionQueryHandle query) override;
+    bool GetResult(OcclusionQueryHandle query, UINT64& samples) override;
+    void ReleaseQuery(OcclusionQueryHandle query) override;
+    int GetPoolSize() const override { return static_cast<int>(m_queries.size()); }
+
+private:
+    ComPtr<ID3D11Device> m_device;
+    ComPtr<ID3D11DeviceContext> m_context;
+    CommonStates* m_states = nullptr;
+    ComPtr<ID3D11BlendState> m_noColorWrites;
+    std::unique_ptr<GeometricPrimitive> m_proxyCube;
+    Matrix m_view;
+    Matrix m_projection;
+
+    std::vector<ComPtr<ID3D11Query>> m_queries;
+    std::vector<OcclusionQueryHandle> m_freeQueries;
+};
+
+// ============================================================================
+// SOFTWARE OCCLUSION QUERY BACKEND
+// ============================================================================
+
+// Answers queries from the CPU depth buffer of a SoftwareOcclusionCuller:
+// the samples are the footprint pixels not behind the stored depth. Results
+// are held back for a configurable number of frames to behave like a GPU,
+// so schedulers can be driven headless and deterministically. Only DrawBox
+// contributes samples; geometry drawn through D3D11 is not seen.
+class SoftwareOcclusionQueryBackend : public IOcclusionQueryBackend {
+public:
+    explicit SoftwareOcclusionQueryBackend(const SoftwareOcclusionCuller& depthSource,
+                                           int latencyFrames = Config::SOFTWARE_QUERY_LATENCY);
+    ~SoftwareOcclusionQueryBackend() = default;
+
+    void BeginFrame() override { m_frame++; }
+    void SetCamera(const Matrix& view, const Matrix& projection) override { m_viewProjection = view * projection; }
+    OcclusionQueryHandle BeginQuery() override;
+    void DrawBox(const QueryBox& box) override;
+    void EndQuery(OcclusionQueryHandle query) override;
+    bool GetResult(OcclusionQueryHandle query, UINT64& samples) override;
+    void ReleaseQuery(OcclusionQueryHandle query) override;
+    int GetPoolSize() const override { return static_cast<int>(m_queries.size()); }
+
+    void SetLatency(int frames) { m_latencyFrames = std::max(frames, 0); }
+
+private:
+    struct Query {
+        UINT64 samples = 0;
+        int readyFrame = 0;
+    };
+
+    const SoftwareOcclusionCuller& m_depthSource;
+    int m_latencyFrames;
+    int m_frame = 0;
+    Matrix m_viewProjection;
+    OcclusionQueryHandle m_openQuery = INVALID_OCCLUSION_QUERY;
+
+    std::vector<Query> m_queries;
+    std::vector<OcclusionQueryHandle> m_freeQueries;
+
+    UINT64 CountVisibleSamples(const QueryBox& box) const;
+};
@@ -0,0 +1,92 @@
+#include "OcclusionQueryRing.h"
+
+// ============================================================================
+// OCCLUSION QUERY RING IMPLEMENTATION
+// ============================================================================
+
+OcclusionQueryRing::OcclusionQueryRing(size_t initialCapacity)
+    : m_entries(std::max<size_t>(initialCapacity, 1)) {
+}
+
+void OcclusionQueryRing::SetBackend(IOcclusionQueryBackend* backend) {
+    Clear();
+    m_backend = backend;
+}
+
+void OcclusionQueryRing::Clear() {
+    if (m_backend) {
+        for (size_t i = 0; i < m_count; i++) {
+            m_backend->ReleaseQuery(m_entries[(m_head + i) % m_entries.size()].query);
+        }
+    }
+    m_head = 0;
+    m_count = 0;
+}
+
+OcclusionQueryHandle OcclusionQueryRing::Begin(int objectIndex, int issueFrame) {
+    if (!m_backend) return INVALID_OCCLUSION_QUERY;
+
+    OcclusionQueryHandle query = m_backend->BeginQuery();
+    if (query == INVALID_OCCLUSION_QUERY) return query;
+
+    if (m_count == m_entries.size()) {
+        Grow();
+    }
+
+    Entry& entry = m_entries[(m_head + m_count) % m_entries.size()];
+    entry.query = query;
+    entry.objectIndex = objectIndex;
+    entry.issueFrame = issueFrame;
+    m_count++;
+    return query;
+}
+
+void OcclusionQueryRing::End(OcclusionQueryHandle query) {
+    if (m_backend && query != INVALID_OCCLUSION_QUERY) {
+        m_backend->EndQuery(query);
+    }
+}
+
+bool OcclusionQueryRing::PopReady(int& objectIndex, UINT64& samples) {
+    if (!m_backend || m_count == 0) return false;
+
+    const Entry& entry = m_entries[m_head];
+    m_pollCount++;
+    if (!m_backend->GetResult(entry.query, samples)) return false;
+
+    objectIndex = entry.objectIndex;
+    m_backend->ReleaseQuery(entry.query);
+    m_head = (m_head + 1) % m_entries.size();
+    m_count--;
+    return true;
+}
+
+void OcclusionQueryRing::RemoveObject(const ObjectRemoval& removal) {
+    for (size_t i = 0; i < m_count; i++) {
+        Entry& entry = m_entries[(m_head + i) % m_entries.size()];
+        if (entry.objectIndex == removal.index) {
+            entry.objectIndex = -1;
+        } else if (entry.objectIndex == removal.movedFrom) {
+            entry.objectIndex = removal.index;
+        }
+    }
+}
+
+void OcclusionQueryRing::RemapObjects(const ObjectReorder& reorder) {
+    for (size_t i = 0; i < m_count; i++) {
+        Entry& entry = m_entries[(m_head + i) % m_entries.size()];
+        if (entry.objectIndex >= 0 && entry.objectIndex < static_cast<int>(reorder.newIndex.size())) {
+            entry.objectIndex = reorder.newIndex[entry.objectIndex];
+        }
+    }
+}
+
+void OcclusionQueryRing::Grow() {
+    // Unwrap into a larger buffer, oldest first
+    std::vector<Entry> entries(m_entries.size() * 2);
+    for (size_t i = 0; i < m_count; i++) {
+        entries[i] = m_entries[(m_head + i) % m_entries.size()];
+    }
+    m_entries.swap(entries);
+    m_head = 0;
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "Common.h"
+#include "OcclusionQueryBackend.h"
+#include "ObjectStore.h"
+
+// ============================================================================
+// OCCLUSION QUERY RING CLASS
+// ============================================================================
+
+// In-flight per-object queries in issue order. The GPU answers queries in the
+// order they were submitted, so reading back stops at the first one that is
+// not ready instead of polling every object. Query objects come from the
+// backend's pool and go back to it as soon as their result has been read.
+class OcclusionQueryRing {
+public:
+    explicit OcclusionQueryRing(size_t initialCapacity = 64);
+    ~OcclusionQueryRing() = default;
+
+    // Releases everything in flight to the old backend first
+    void SetBackend(IOcclusionQueryBackend* backend);
+    void Clear();
+
+    // Opens a query for objectIndex and appends it; draw between Begin and End
+    OcclusionQueryHandle Begin(int objectIndex, int issueFrame);
+    void End(OcclusionQueryHandle query);
+
+    // Pops the oldest query if its result is ready. False when the ring is empty
+    // or the oldest query is still outstanding - nothing behind it is polled.
+    bool PopReady(int& objectIndex, UINT64& samples);
+
+    // Follows the store's swap-remove; the removed object's queries come back with index -1
+    void RemoveObject(const ObjectRemoval& removal);
+    void RemapObjects(const ObjectReorder& reorder);
+
+    size_t GetPendingCount() const { return m_count; }
+    size_t GetCapacity() const { return m_entries.size(); }
+    // Frame the oldest query was issued in, -1 when empty
+    int GetOldestIssueFrame() const { return m_count > 0 ? m_entries[m_head].issueFrame : -1; }
+    int GetPollCount() const { return m_pollCount; }
+    void ResetPollCount() { m_pollCount = 0; }
+
+private:
+    struct Entry {
+        OcclusionQueryHandle query = INVALID_OCCLUSION_QUERY;
+        int objectIndex = -1;
+        int issueFrame = 0;
+    };
+
+    IOcclusionQueryBackend* m_backend = nullptr;
+    std::vector<Entry> m_entries;
+    size_t m_head = 0;
+    size_t m_count = 0;
+    int m_pollCount = 0;
+
+    void Grow();
+};
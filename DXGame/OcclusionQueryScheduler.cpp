@@ -0,0 +1,414 @@
+#include "OcclusionQueryScheduler.h"
+
+void OcclusionQueryScheduler::SetBackend(IOcclusionQueryBackend* backend) {
+    Reset();
+    m_backend = backend;
+}
+
+void OcclusionQueryScheduler::Reset() {
+    if (m_backend) {
+        for (const auto& pending : m_pendingQueries) {
+            m_backend->ReleaseQuery(pending.handle);
+        }
+    }
+    m_pendingQueries.clear();
+    m_visibleQueue.clear();
+    m_invisibleQueue.clear();
+
+    // Everything is visible again until queries say otherwise
+    std::fill(m_nodeStates.begin(), m_nodeStates.end(), NodeState());
+}
+
+void OcclusionQueryScheduler::Update(const Frustum& frustum, const Vector3& cameraPosition, float nearPlane,
+                                     ObjectStore& objects) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    // Queries go out after the stats are logged, so the issue counters cover the previous frame
+    QuerySchedulerStats previous = m_stats;
+    m_stats.Reset();
+    m_stats.queriesIssued = previous.queriesIssued;
+    m_stats.multiQueries = previous.multiQueries;
+    m_stats.nodesQueried = previous.nodesQueried;
+    m_frame++;
+
+    m_visibleQueue.clear();
+    m_invisibleQueue.clear();
+    if (!m_backend || objects.Empty()) return;
+
+    SyncHierarchy(objects);
+    if (!m_hierarchy.IsValid()) return;
+
+    m_backend->BeginFrame();
+    ProcessResults();
+    Traverse(frustum, cameraPosition, nearPlane, objects);
+
+    m_stats.pendingQueries = static_cast<int>(m_pendingQueries.size());
+    m_stats.scheduleTimeMs = std::chrono::duration<float, std::milli>(
+        std::chrono::high_resolution_clock::now() - startTime).count();
+}
+
+void OcclusionQueryScheduler::IssueQueries(const Matrix& view, const Matrix& projection) {
+    m_stats.queriesIssued = 0;
+    m_stats.multiQueries = 0;
+    m_stats.nodesQueried = 0;
+    if (!m_backend || (m_visibleQueue.empty() && m_invisibleQueue.empty())) return;
+    m_backend->SetCamera(view, projection);
+
+    // Nodes that stayed invisible for a while are expected to stay so - batch
+    // neighbours in traversal order, one query for all of them
+    int batch[Config::MAX_MULTI_QUERY_NODES];
+    int batchSize = 0;
+    for (int nodeIndex : m_invisibleQueue) {
+        if (m_nodeStates[nodeIndex].invisibleFrames < Config::MULTI_QUERY_MIN_INVISIBLE_FRAMES) {
+            Issue(&nodeIndex, 1);
+            continue;
+        }
+
+        batch[batchSize++] = nodeIndex;
+        if (batchSize == Config::MAX_MULTI_QUERY_NODES) {
+            Issue(batch, batchSize);
+            batchSize = 0;
+        }
+    }
+    if (batchSize > 0) {
+        Issue(batch, batchSize);
+    }
+
+    for (int nodeIndex : m_visibleQueue) {
+        Issue(&nodeIndex, 1);
+    }
+
+    m_visibleQueue.clear();
+    m_invisibleQueue.clear();
+}
+
+void OcclusionQueryScheduler::InsertObject(const ObjectStore& objects, int objectIndex) {
+    if (!m_hierarchy.IsValid()) return;
+    m_hierarchy.InsertObject(objects, objectIndex);
+    m_hierarchyLayoutVersion++;
+    m_topologyChanged = true;
+
+    // The new leaf and the parent made for it start from a default state, freed
+    // nodes were forgotten already. A spawned object is drawn and checked like one
+    // coming into view, so the subtrees above it are traversed again. Their boxes
+    // grew, so a result still in flight for the old box no longer applies.
+    m_nodeStates.resize(m_hierarchy.GetNodes().Size());
+    int leaf = m_hierarchy.GetObjectLeaf(objectIndex);
+    for (int parent = leaf >= 0 ? m_hierarchy.GetParent(leaf) : -1; parent >= 0; parent = m_hierarchy.GetParent(parent)) {
+        DropPendingQuery(parent);
+        m_nodeStates[parent].visible = true;
+        m_nodeStates[parent].invisibleFrames = 0;
+    }
+}
+
+void OcclusionQueryScheduler::RemoveObject(const ObjectRemoval& removal) {
+    if (!m_hierarchy.IsValid()) return;
+
+    // The leaf and its parent are freed; the sibling takes the parent's place
+    int leaf = m_hierarchy.GetObjectLeaf(removal.index);
+    int parent = leaf >= 0 ? m_hierarchy.GetParent(leaf) : -1;
+    m_hierarchy.RemoveObject(removal);
+    m_hierarchyLayoutVersion++;
+    m_topologyChanged = true;
+
+    if (leaf >= 0) {
+        ForgetNode(leaf);
+    }
+    if (parent >= 0) {
+        ForgetNode(parent);
+    }
+}
+
+void OcclusionQueryScheduler::RemapObjects(const ObjectReorder& reorder) {
+    if (!m_hierarchy.IsValid()) return;
+
+    // Leaves are relabelled in place; nodes and their bounds stay as they are
+    m_hierarchy.RemapObjects(reorder);
+    m_hierarchyLayoutVersion++;
+}
+
+void OcclusionQueryScheduler::DropPendingQuery(int nodeIndex) {
+    if (!m_nodeStates[nodeIndex].queryPending) return;
+
+    // The query stays in flight for the other nodes it covers
+    for (PendingQuery& pending : m_pendingQueries) {
+        for (int i = 0; i < pending.nodeCount; i++) {
+            if (pending.nodes[i] == nodeIndex) {
+                pending.nodes[i] = -1;
+            }
+        }
+    }
+    m_nodeStates[nodeIndex].queryPending = false;
+}
+
+void OcclusionQueryScheduler::ForgetNode(int nodeIndex) {
+    if (nodeIndex >= static_cast<int>(m_nodeStates.size())) return;
+
+    DropPendingQuery(nodeIndex);
+    m_visibleQueue.erase(std::remove(m_visibleQueue.begin(), m_visibleQueue.end(), nodeIndex), m_visibleQueue.end());
+    m_invisibleQueue.erase(std::remove(m_invisibleQueue.begin(), m_invisibleQueue.end(), nodeIndex), m_invisibleQueue.end());
+    m_nodeStates[nodeIndex] = NodeState();
+}
+
+void OcclusionQueryScheduler::SyncHierarchy(const ObjectStore& objects) {
+    bool rebuilt = false;
+    // Edits that were not replayed leave the version behind; a swap-remove followed
+    // by a spawn keeps the count but not the indices
+    if (!m_hierarchy.IsValid() || m_hierarchyLayoutVersion != objects.GetLayoutVersion()) {
+        Reset();
+        m_hierarchy.BuildBVH(objects);
+        m_hierarchyLayoutVersion = objects.GetLayoutVersion();
+        m_nodeStates.assign(m_hierarchy.GetNodes().Size(), NodeState());
+        rebuilt = true;
+    }
+    if (m_drawn.Size() != objects.Size()) {
+        m_drawn.Assign(objects.Size(), false);
+    }
+
+    // Only the bounds change while objects move
+    bool moved = rebuilt || m_topologyChanged;
+    if (moved) {
+        // A node is queued and queried at most once per frame, so sizing to the
+        // tree keeps traversal off the heap until the next edit
+        size_t nodeCount = m_hierarchy.GetNodes().Size();
+        m_refitOrder.reserve(nodeCount);
+        m_traversalStack.reserve(nodeCount);
+        m_visibleQueue.reserve(nodeCount);
+        m_invisibleQueue.reserve(nodeCount);
+        m_pendingQueries.reserve(nodeCount);
+        UpdateRefitOrder();
+        m_topologyChanged = false;
+    }
+    for (size_t i = 0; i < objects.Size() && !moved; i++) {
+        moved = objects.HasMoved(i);
+    }
+    if (moved) {
+        RefitHierarchy(objects);
+    }
+}
+
+void OcclusionQueryScheduler::UpdateRefitOrder() {
+    const auto& nodes = m_hierarchy.GetNodes();
+    m_refitOrder.clear();
+    m_traversalStack.clear();
+    m_traversalStack.push_back(m_hierarchy.GetRootNode());
+    while (!m_traversalStack.empty()) {
+        int nodeIndex = m_traversalStack.back();
+        m_traversalStack.pop_back();
+        m_refitOrder.push_back(nodeIndex);
+        if (!nodes[nodeIndex].isLeaf) {
+            m_traversalStack.push_back(nodes[nodeIndex].leftChild);
+            m_traversalStack.push_back(nodes[nodeIndex].rightChild);
+        }
+    }
+}
+
+void OcclusionQueryScheduler::RefitHierarchy(const ObjectStore& objects) {
+    const auto& nodes = m_hierarchy.GetNodes();
+    m_nodeMin.resize(nodes.Size());
+    m_nodeMax.resize(nodes.Size());
+
+    // Incremental edits scatter nodes through the pool, so the sweep follows the
+    // tree: in reverse, both children of a node come before the node itself
+    for (auto it = m_refitOrder.rbegin(); it != m_refitOrder.rend(); ++it) {
+        const BVHNode& node = nodes[*it];
+        if (node.isLeaf) {
+            m_nodeMin[*it] = objects.bounds[node.objectIndex].minBounds;
+            m_nodeMax[*it] = objects.bounds[node.objectIndex].maxBounds;
+        } else {
+            m_nodeMin[*it] = Vector3::Min(m_nodeMin[node.leftChild], m_nodeMin[node.rightChild]);
+            m_nodeMax[*it] = Vector3::Max(m_nodeMax[node.leftChild], m_nodeMax[node.rightChild]);
+        }
+    }
+}
+
+void OcclusionQueryScheduler::ProcessResults() {
+    size_t kept = 0;
+    for (size_t i = 0; i < m_pendingQueries.size(); i++) {
+        const PendingQuery& pending = m_pendingQueries[i];
+
+        UINT64 samples = 0;
+        if (!m_backend->GetResult(pending.handle, samples)) {
+            m_pendingQueries[kept++] = pending;
+            continue;
+        }
+
+        m_stats.resultsReceived++;
+        ApplyResult(pending, samples > 0);
+        m_backend->ReleaseQuery(pending.handle);
+    }
+    m_pendingQueries.resize(kept);
+}
+
+void OcclusionQueryScheduler::ApplyResult(const PendingQuery& query, bool visible) {
+    if (visible && query.nodeCount > 1) {
+        // Which node was seen is unknown: draw them all, their leaves get checked individually
+        m_stats.multiQueryFailures++;
+    }
+
+    for (int i = 0; i < query.nodeCount; i++) {
+        int nodeIndex = query.nodes[i];
+        if (nodeIndex < 0) continue;    // Dropped by a spawn or despawn while in flight
+        NodeState& state = m_nodeStates[nodeIndex];
+        state.queryPending = false;
+
+        if (visible) {
+            if (!state.visible) {
+                m_stats.nodesTurnedVisible++;
+            }
+            state.visible = true;
+            state.invisibleFrames = 0;
+            state.nextQueryFrame = NextRecheckFrame();
+
+            // Ancestors are traversed again; descendants keep their recent state and
+            // anything not seen for a while is drawn and re-checked by traversal
+            for (int parent = m_hierarchy.GetParent(nodeIndex); parent >= 0 && !m_nodeStates[parent].visible;
+                 parent = m_hierarchy.GetParent(parent)) {
+                m_nodeStates[parent].visible = true;
+                m_nodeStates[parent].invisibleFrames = 0;
+            }
+        } else if (state.visible) {
+            state.visible = false;
+            state.invisibleFrames = 1;
+            m_stats.nodesTurnedInvisible++;
+            PullUpInvisible(nodeIndex);
+        } else {
+            state.invisibleFrames++;
+        }
+    }
+}
+
+void OcclusionQueryScheduler::PullUpInvisible(int nodeIndex) {
+    // A sibling's state only counts if traversal saw it last frame - an old
+    // result from before it left the view says nothing about it now
+    auto isHidden = [this](int child) {
+        return !m_nodeStates[child].visible && m_nodeStates[child].lastVisitedFrame >= m_frame - 1;
+    };
+
+    const auto& nodes = m_hierarchy.GetNodes();
+    for (int parent = m_hierarchy.GetParent(nodeIndex); parent >= 0; parent = m_hierarchy.GetParent(parent)) {
+        NodeState& parentState = m_nodeStates[parent];
+        const BVHNode& parentNode = nodes[parent];
+        if (!parentState.visible || !isHidden(parentNode.leftChild) || !isHidden(parentNode.rightChild)) {
+            break;
+        }
+
+        parentState.visible = false;
+        parentState.invisibleFrames = 1;
+        m_stats.nodesTurnedInvisible++;
+    }
+}
+
+void OcclusionQueryScheduler::Traverse(const Frustum& frustum, const Vector3& cameraPosition, float nearPlane,
+                                       ObjectStore& objects) {
+    const auto& nodes = m_hierarchy.GetNodes();
+
+    // Proxies near the camera get clipped by the near plane and can miss samples,
+    // so nodes within this margin are always drawn and never queried
+    Vector3 cameraMargin = Vector3::One * (2.0f * nearPlane);
+
+    m_drawn.ResetAll();
+    m_traversalStack.clear();
+    m_traversalStack.push_back(m_hierarchy.GetRootNode());
+    while (!m_traversalStack.empty()) {
+        int nodeIndex = m_traversalStack.back();
+        m_traversalStack.pop_back();
+
+        const Vector3& nodeMin = m_nodeMin[nodeIndex];
+        const Vector3& nodeMax = m_nodeMax[nodeIndex];
+        if (!frustum.IsBoxInFrustum(nodeMin, nodeMax)) continue;
+        m_stats.nodesVisited++;
+
+        NodeState& state = m_nodeStates[nodeIndex];
+        bool historyExpired = state.lastVisitedFrame < m_frame - Config::QUERY_HISTORY_FRAMES;
+        state.lastVisitedFrame = m_frame;
+
+        // Nodes coming back into view after a while have no usable history - draw them and check at once.
+        // Recent history is kept, so a parent seen again through the gaps between its hidden
+        // children does not draw them all just to hide them again.
+        if (historyExpired) {
+            state.visible = true;
+            state.invisibleFrames = 0;
+            state.nextQueryFrame = m_frame;
+        }
+
+        Vector3 marginMin = nodeMin - cameraMargin;
+        Vector3 marginMax = nodeMax + cameraMargin;
+        bool nearCamera = cameraPosition.x >= marginMin.x && cameraPosition.x <= marginMax.x &&
+                          cameraPosition.y >= marginMin.y && cameraPosition.y <= marginMax.y &&
+                          cameraPosition.z >= marginMin.z && cameraPosition.z <= marginMax.z;
+        if (nearCamera) {
+            state.visible = true;
+        }
+
+        if (!state.visible) {
+            m_stats.invisibleNodes++;
+            if (!state.queryPending) {
+                m_invisibleQueue.push_back(nodeIndex);
+            }
+            continue;
+        }
+
+        const BVHNode& node = nodes[nodeIndex];
+        if (node.isLeaf) {
+            if (!objects.visible.Test(node.objectIndex)) continue;
+
+            m_drawn.Set(node.objectIndex);
+            if (!nearCamera && !state.queryPending && state.nextQueryFrame <= m_frame) {
+                m_visibleQueue.push_back(nodeIndex);
+            } else {
+                m_stats.visibleQueriesSkipped++;
+            }
+            continue;
+        }
+
+        // Front to back: the nearer child is pushed last so it pops first
+        Vector3 leftCenter = (m_nodeMin[node.leftChild] + m_nodeMax[node.leftChild]) * 0.5f;
+        Vector3 rightCenter = (m_nodeMin[node.rightChild] + m_nodeMax[node.rightChild]) * 0.5f;
+        bool leftNearer = (leftCenter - cameraPosition).LengthSquared() < (rightCenter - cameraPosition).LengthSquared();
+        m_traversalStack.push_back(leftNearer ? node.rightChild : node.leftChild);
+        m_traversalStack.push_back(leftNearer ? node.leftChild : node.rightChild);
+    }
+
+    // Frustum-visible objects the traversal did not reach are under invisible nodes
+    m_stats.objectsHidden += static_cast<int>(objects.visible.CountAndNot(m_drawn));
+    objects.visible.And(m_drawn);
+}
+
+void OcclusionQueryScheduler::Issue(const int* nodes, int count) {
+    QueryBox boxes[Config::MAX_MULTI_QUERY_NODES];
+    for (int i = 0; i < count; i++) {
+        boxes[i].minBounds = m_nodeMin[nodes[i]];
+        boxes[i].maxBounds = m_nodeMax[nodes[i]];
+    }
+
+    OcclusionQueryHandle handle = m_backend->IssueQuery(boxes, count);
+    if (handle == INVALID_OCCLUSION_QUERY) {
+        // Without a query an invisible node could never come back - draw it instead
+        for (int i = 0; i < count; i++) {
+            m_nodeStates[nodes[i]].visible = true;
+        }
+        return;
+    }
+
+    PendingQuery pending;
+    pending.handle = handle;
+    pending.nodeCount = count;
+    for (int i = 0; i < count; i++) {
+        pending.nodes[i] = nodes[i];
+        m_nodeStates[nodes[i]].queryPending = true;
+    }
+    m_pendingQueries.push_back(pending);
+
+    m_stats.queriesIssued++;
+    m_stats.nodesQueried += count;
+    if (count > 1) {
+        m_stats.multiQueries++;
+    }
+}
+
+int OcclusionQueryScheduler::NextRecheckFrame() {
+    // Spread re-checks over [interval/2, interval] so they do not all land on one frame
+    int halfInterval = std::max(Config::VISIBLE_QUERY_INTERVAL / 2, 1);
+    return m_frame + halfInterval + static_cast<int>(m_random() % static_cast<uint32_t>(halfInterval + 1));
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "Common.h"
+#include "Structures.h"
+#include "CPUBVHSystem.h"
+#include "OcclusionQueryBackend.h"
+
+// ============================================================================
+// OCCLUSION QUERY SCHEDULER CLASS (CHC++-style)
+// ============================================================================
+
+enum class QuerySchedulingMode {
+    PerObject,              // One hardware query per drawn object, every frame
+    Hierarchical,           // Scheduled node queries on the D3D11 backend
+    HierarchicalSoftware    // Same scheduling, answered by the CPU depth buffer
+};
+
+// Coherent hierarchical culling over a BVH. Nodes that saw no samples last
+// frame are not traversed - their whole subtree is skipped and only the node
+// is queried, with long-invisible neighbours batched into one multi-query.
+// Visible leaves are trusted and re-checked at randomized intervals. An
+// invisible leaf pulls its parent down with it once its sibling is hidden
+// too, so the skipped subtrees grow towards the root.
+class OcclusionQueryScheduler {
+public:
+    OcclusionQueryScheduler() = default;
+    ~OcclusionQueryScheduler() = default;
+
+    // Drops pending queries and history; nullptr disables scheduling
+    void SetBackend(IOcclusionQueryBackend* backend);
+    void Reset();
+
+    // Reads back ready results, then walks the hierarchy front to back and
+    // hides objects under invisible nodes. obj.visible must hold this frame's
+    // frustum results; this frame's queries are collected for IssueQueries.
+    void Update(const Frustum& frustum, const Vector3& cameraPosition, float nearPlane,
+                ObjectStore& objects);
+
+    // Submits the collected queries - after the drawn geometry is in the depth buffer
+    void IssueQueries(const Matrix& view, const Matrix& projection);
+    
+    // Store edits replayed on the hierarchy, as the culling BVH replays them, so
+    // every node the edit leaves in place keeps its history. Each call follows
+    // its ObjectStore edit, which bumps the layout version once; a version the
+    // replays do not account for rebuilds the hierarchy from scratch.
+    void InsertObject(const ObjectStore& objects, int objectIndex);
+    void RemoveObject(const ObjectRemoval& removal);
+    void RemapObjects(const ObjectReorder& reorder);
+
+    const QuerySchedulerStats& GetStats() const { return m_stats; }
+
+private:
+    struct NodeState {
+        bool visible = true;
+        bool queryPending = false;
+        int lastVisitedFrame = -1;
+        int nextQueryFrame = 0;     // Visible leaves: frame of the next re-check
+        int invisibleFrames = 0;    // Consecutive invisible results
+    };
+
+    struct PendingQuery {
+        OcclusionQueryHandle handle = INVALID_OCCLUSION_QUERY;
+        int nodes[Config::MAX_MULTI_QUERY_NODES];
+        int nodeCount = 0;
+    };
+
+    IOcclusionQueryBackend* m_backend = nullptr;
+
+    // Own topology, refit every frame - the culling BVH is rebuilt whenever
+    // something moves, which would throw the visibility history away
+    CPUBVHSystem m_hierarchy;
+    uint32_t m_hierarchyLayoutVersion = 0;   // Store layout the hierarchy matches
+    bool m_topologyChanged = false;          // Edited since m_refitOrder was taken
+    std::vector<int> m_refitOrder;           // Reachable nodes, parents before children
+    std::vector<Vector3> m_nodeMin;
+    std::vector<Vector3> m_nodeMax;
+    std::vector<NodeState> m_nodeStates;
+
+    std::vector<int> m_traversalStack;
+    std::vector<int> m_visibleQueue;     // Leaves due for a re-check
+    std::vector<int> m_invisibleQueue;   // Roots of skipped subtrees, front to back
+    std::vector<PendingQuery> m_pendingQueries;
+    VisibilitySet m_drawn;               // Objects reached by this frame's traversal
+
+    std::mt19937 m_random{ 12345u };
+    int m_frame = 0;
+    QuerySchedulerStats m_stats;
+
+    void SyncHierarchy(const ObjectStore& objects);
+    void RefitHierarchy(const ObjectStore& objects);
+    void UpdateRefitOrder();
+    // The node's result is ignored when its query comes back
+    void DropPendingQuery(int nodeIndex);
+    // A freed node's index is handed out again: its history and queries go with it
+    void ForgetNode(int nodeIndex);
+    void ProcessResults();
+    void ApplyResult(const PendingQuery& query, bool visible);
+    void Traverse(const Frustum& frustum, const Vector3& cameraPosition, float nearPlane,
+                  ObjectStore& objects);
+    void Issue(const int* nodes, int count);
+    void PullUpInvisible(int nodeIndex);
+    int NextRecheckFrame();
+};
@@ -0,0 +1,162 @@
+#include "PVSBaker.h"
+
+namespace {
+    // Cube map faces: forward and up per face
+    const Vector3 kFaceForward[6] = {
+        Vector3(1, 0, 0), Vector3(-1, 0, 0), Vector3(0, 1, 0), Vector3(0, -1, 0), Vector3(0, 0, 1), Vector3(0, 0, -1)
+    };
+    const Vector3 kFaceUp[6] = {
+        Vector3(0, 1, 0), Vector3(0, 1, 0), Vector3(0, 0, -1), Vector3(0, 0, 1), Vector3(0, 1, 0), Vector3(0, 1, 0)
+    };
+    constexpr float kBakeNearPlane = 0.1f;
+}
+
+// ============================================================================
+// PVS BAKER IMPLEMENTATION
+// ============================================================================
+
+PVSBaker::PVSBaker(int width, int height)
+    : m_culler(width, height) {
+}
+
+bool PVSBaker::Bake(const ObjectStore& objects, const Vector3& minBounds, const Vector3& maxBounds,
+                    float cellSize, PotentiallyVisibleSet& pvs) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+    m_stats.Reset();
+
+    if (objects.Empty() || cellSize <= 0.0f) return false;
+
+    pvs.Reset(minBounds, maxBounds, cellSize, objects.Size(), PotentiallyVisibleSet::ComputeSceneSignature(objects));
+
+    m_staticObjects.clear();
+    for (size_t i = 0; i < objects.Size(); ++i) {
+        if (!objects.dynamic[i]) {
+            m_staticObjects.push_back(static_cast<int>(i));
+        }
+    }
+
+    int cellsX = pvs.GetCellsX();
+    int cellsY = pvs.GetCellsY();
+    int cellsZ = pvs.GetCellsZ();
+    size_t cellCount = pvs.GetCellCount();
+    size_t wordCount = (objects.Size() + 31) / 32;
+    std::vector<uint32_t> cellBits(cellCount * wordCount, 0u);
+
+    int steps = m_samplesPerAxis - 1;
+    float spacing = cellSize / steps;
+    // Every point of a cell is within half a spacing per axis of a sample point. Seen from that
+    // point, the scene shifted by the offset looks the same; eroding occluders and dilating
+    // occludees by half a spacing covers every such shift.
+    float padding = spacing * 0.5f;
+    Vector3 gridMax = minBounds + Vector3(static_cast<float>(cellsX), static_cast<float>(cellsY),
+                                          static_cast<float>(cellsZ)) * cellSize;
+    float farPlane = std::max((gridMax - minBounds).Length() * 2.0f, kBakeNearPlane * 2.0f);
+
+    // Sample points form one lattice over the grid; each adds its set to every cell it touches
+    int pointsX = cellsX * steps + 1;
+    int pointsY = cellsY * steps + 1;
+    int pointsZ = cellsZ * steps + 1;
+    for (int pz = 0; pz < pointsZ; pz++) {
+        for (int py = 0; py < pointsY; py++) {
+            for (int px = 0; px < pointsX; px++) {
+                Vector3 position = minBounds + Vector3(static_cast<float>(px), static_cast<float>(py),
+                                                       static_cast<float>(pz)) * spacing;
+                m_pointBits.assign(wordCount, 0u);
+                RenderSamplePoint(objects, position, farPlane, padding);
+                m_stats.samplePoints++;
+
+                int cx0 = std::max((px - 1) / steps, 0), cx1 = std::min(px / steps, cellsX - 1);
+                int cy0 = std::max((py - 1) / steps, 0), cy1 = std::min(py / steps, cellsY - 1);
+                int cz0 = std::max((pz - 1) / steps, 0), cz1 = std::min(pz / steps, cellsZ - 1);
+                for (int cz = cz0; cz <= cz1; cz++) {
+                    for (int cy = cy0; cy <= cy1; cy++) {
+                        for (int cx = cx0; cx <= cx1; cx++) {
+                            uint32_t* bits = &cellBits[((static_cast<size_t>(cz) * cellsY + cy) * cellsX + cx) * wordCount];
+                            for (size_t w = 0; w < wordCount; w++) {
+                                bits[w] |= m_pointBits[w];
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // Objects reaching into the cell cross the near plane somewhere inside it
+    std::vector<uint32_t> words(wordCount);
+    size_t visibleSum = 0;
+    for (size_t cell = 0; cell < cellCount; cell++) {
+        int cx = static_cast<int>(cell % cellsX);
+        int cy = static_cast<int>((cell / cellsX) % cellsY);
+        int cz = static_cast<int>(cell / (static_cast<size_t>(cellsX) * cellsY));
+        Vector3 cellMin = minBounds + Vector3(static_cast<float>(cx), static_cast<float>(cy), static_cast<float>(cz)) * cellSize;
+        Vector3 cellMax = cellMin + Vector3(cellSize, cellSize, cellSize);
+        Vector3 pad(padding + kBakeNearPlane, padding + kBakeNearPlane, padding + kBakeNearPlane);
+
+        std::copy(cellBits.begin() + cell * wordCount, cellBits.begin() + (cell + 1) * wordCount, words.begin());
+        for (int index : m_staticObjects) {
+            const ObjectBounds& bounds = objects.bounds[index];
+            bool overlaps = bounds.minBounds.x <= cellMax.x + pad.x && bounds.maxBounds.x >= cellMin.x - pad.x &&
+                            bounds.minBounds.y <= cellMax.y + pad.y && bounds.maxBounds.y >= cellMin.y - pad.y &&
+                            bounds.minBounds.z <= cellMax.z + pad.z && bounds.maxBounds.z >= cellMin.z - pad.z;
+            if (overlaps) {
+                words[index >> 5] |= 1u << (index & 31);
+            }
+        }
+
+        for (uint32_t word : words) {
+            for (; word; word &= word - 1) visibleSum++;
+        }
+        pvs.AddCell(words);
+    }
+
+    m_stats.cells = static_cast<int>(cellCount);
+    m_stats.distinctSets = static_cast<int>(pvs.GetDistinctSetCount());
+    m_stats.staticObjects = static_cast<int>(m_staticObjects.size());
+    m_stats.averageVisible = cellCount > 0 ? static_cast<float>(visibleSum) / cellCount : 0.0f;
+    m_stats.compressedBytes = static_cast<int>(pvs.GetCompressedBytes());
+    m_stats.uncompressedBytes = static_cast<int>(pvs.GetUncompressedBytes());
+    m_stats.bakeTimeMs = std::chrono::duration<float, std::milli>(
+        std::chrono::high_resolution_clock::now() - startTime).count();
+    return pvs.IsValid();
+}
+
+void PVSBaker::RenderSamplePoint(const ObjectStore& objects, const Vector3& position,
+                                 float farPlane, float padding) {
+    Matrix projection = Matrix::CreatePerspectiveFieldOfView(XM_PIDIV2, 1.0f, kBakeNearPlane, farPlane);
+    Vector3 pad(padding, padding, padding);
+
+    for (int face = 0; face < 6; face++) {
+        Matrix viewProjection = Matrix::CreateLookAt(position, position + kFaceForward[face], kFaceUp[face]) * projection;
+        Frustum frustum;
+        frustum.ExtractFromMatrix(viewProjection);
+
+        // Every static occluder, not a budgeted selection - this runs offline
+        m_culler.BeginFrame(viewProjection, position);
+        for (int index : m_staticObjects) {
+            const ObjectBounds& bounds = objects.bounds[index];
+            if (!objects.IsOccluder(index) || !frustum.IsBoxInFrustum(bounds.minBounds, bounds.maxBounds)) continue;
+
+            Vector3 occluderMin, occluderMax;
+            objects.GetOccluderBounds(index, occluderMin, occluderMax);
+            occluderMin += pad;
+            occluderMax -= pad;
+            if (occluderMin.x < occluderMax.x && occluderMin.y < occluderMax.y && occluderMin.z < occluderMax.z) {
+                m_culler.RasterizeOccluder(occluderMin, occluderMax);
+            }
+        }
+        m_stats.facesRendered++;
+
+        for (int index : m_staticObjects) {
+            uint32_t bit = 1u << (index & 31);
+            if (m_pointBits[index >> 5] & bit) continue;
+
+            const ObjectBounds& bounds = objects.bounds[index];
+            Vector3 testMin = bounds.minBounds - pad;
+            Vector3 testMax = bounds.maxBounds + pad;
+            if (frustum.IsBoxInFrustum(testMin, testMax) && !m_culler.IsOccluded(testMin, testMax)) {
+                m_pointBits[index >> 5] |= bit;
+            }
+        }
+    }
+}
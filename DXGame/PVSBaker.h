@@ -0,0 +1,43 @@
+#pragma once
+
+#include "Common.h"
+#include "Structures.h"
+#include "ObjectStore.h"
+#include "SoftwareOcclusionCuller.h"
+#include "PotentiallyVisibleSet.h"
+
+// ============================================================================
+// PVS BAKER CLASS (offline)
+// ============================================================================
+
+// Fills a PotentiallyVisibleSet for the static objects of a scene. Every cell
+// edge gets PVS_SAMPLES_PER_AXIS sample points; from each point all static
+// occluders are rasterized into the six faces of a cube map and every static
+// object is tested against them, and a cell keeps whatever any of its points
+// saw. Points on shared faces and corners are rendered once for all their cells.
+// To cover the space between points, occluders shrink and occludees grow by
+// half the sample spacing, and anything touching the padded cell is always visible.
+class PVSBaker {
+public:
+    PVSBaker(int width = Config::PVS_BAKE_WIDTH, int height = Config::PVS_BAKE_HEIGHT);
+    ~PVSBaker() = default;
+
+    void SetSamplesPerAxis(int samples) { m_samplesPerAxis = std::max(samples, 2); }
+
+    bool Bake(const ObjectStore& objects, const Vector3& minBounds, const Vector3& maxBounds,
+              float cellSize, PotentiallyVisibleSet& pvs);
+
+    const PVSBakeStats& GetStats() const { return m_stats; }
+
+private:
+    SoftwareOcclusionCuller m_culler;
+    int m_samplesPerAxis = Config::PVS_SAMPLES_PER_AXIS;
+    PVSBakeStats m_stats;
+
+    std::vector<int> m_staticObjects;
+    std::vector<uint32_t> m_pointBits;
+
+    // ORs the static objects visible from position into m_pointBits
+    void RenderSamplePoint(const ObjectStore& objects, const Vector3& position,
+                           float farPlane, float padding);
+};
@@ -0,0 +1,326 @@
+#include "PortalSystem.h"
+
+namespace {
+    bool BoxesOverlap(const Vector3& minA, const Vector3& maxA, const Vector3& minB, const Vector3& maxB) {
+        return minA.x <= maxB.x && maxA.x >= minB.x &&
+               minA.y <= maxB.y && maxA.y >= minB.y &&
+               minA.z <= maxB.z && maxA.z >= minB.z;
+    }
+
+    // Clip-space w below which a point is treated as behind the camera
+    constexpr float kMinClipW = 1e-4f;
+}
+
+// ============================================================================
+// PORTAL SYSTEM IMPLEMENTATION
+// ============================================================================
+
+int PortalSystem::AddCell(const Vector3& minBounds, const Vector3& maxBounds) {
+    Cell cell;
+    cell.minBounds = Vector3::Min(minBounds, maxBounds);
+    cell.maxBounds = Vector3::Max(minBounds, maxBounds);
+    m_cells.push_back(std::move(cell));
+    m_built = false;
+    return static_cast<int>(m_cells.size() - 1);
+}
+
+int PortalSystem::AddPortal(int cellA, int cellB, const Vector3 corners[4]) {
+    int cellCount = static_cast<int>(m_cells.size());
+    if (cellA < 0 || cellB < 0 || cellA >= cellCount || cellB >= cellCount || cellA == cellB) {
+        OutputDebugStringA("PortalSystem: portal between invalid cells ignored\n");
+        return -1;
+    }
+
+    Portal portal;
+    std::copy(corners, corners + 4, portal.corners);
+    portal.cells[0] = cellA;
+    portal.cells[1] = cellB;
+    m_portals.push_back(portal);
+
+    int portalIndex = static_cast<int>(m_portals.size() - 1);
+    m_cells[cellA].portals.push_back(portalIndex);
+    m_cells[cellB].portals.push_back(portalIndex);
+    m_built = false;
+    return portalIndex;
+}
+
+void PortalSystem::Clear() {
+    m_cells.clear();
+    m_portals.clear();
+    m_dynamicObjects.clear();
+    m_dynamicSlot.clear();
+    m_built = false;
+}
+
+void PortalSystem::Build(const ObjectStore& objects) {
+    std::vector<std::vector<int>> cellObjects(m_cells.size());
+    std::vector<int> looseObjects;     // Static, in no cell
+    m_dynamicObjects.clear();
+    m_dynamicSlot.assign(objects.Size(), -1);
+
+    for (size_t i = 0; i < objects.Size(); ++i) {
+        if (objects.dynamic[i]) {
+            AddDynamicObject(static_cast<int>(i));
+            continue;
+        }
+
+        // Walls between rooms belong to both, they are seen from either side
+        bool inCell = false;
+        for (size_t c = 0; c < m_cells.size(); ++c) {
+            const Cell& cell = m_cells[c];
+            if (BoxesOverlap(objects.bounds[i].minBounds, objects.bounds[i].maxBounds, cell.minBounds, cell.maxBounds)) {
+                cellObjects[c].push_back(static_cast<int>(i));
+                inCell = true;
+            }
+        }
+        if (!inCell) {
+            looseObjects.push_back(static_cast<int>(i));
+        }
+    }
+
+    for (size_t c = 0; c < m_cells.size(); ++c) {
+        Cell& cell = m_cells[c];
+        if (!cell.bvh) {
+            cell.bvh = std::make_unique<CPUBVHSystem>();
+        }
+        cell.bvh->BuildBVH(objects, cellObjects[c]);
+    }
+    m_looseBVH.BuildBVH(objects, looseObjects);
+
+    m_cellsOnPath.assign(m_cells.size(), 0);
+    m_built = true;
+}
+
+void PortalSystem::InsertObject(const ObjectStore& objects, int objectIndex) {
+    if (!m_built || objectIndex < 0 || objectIndex >= static_cast<int>(objects.Size())) return;
+
+    if (objects.dynamic[objectIndex]) {
+        AddDynamicObject(objectIndex);
+        return;
+    }
+
+    const ObjectBounds& bounds = objects.bounds[objectIndex];
+    bool inCell = false;
+    for (auto& cell : m_cells) {
+        if (BoxesOverlap(bounds.minBounds, bounds.maxBounds, cell.minBounds, cell.maxBounds)) {
+            cell.bvh->InsertObject(objects, objectIndex);
+            inCell = true;
+        }
+    }
+    if (!inCell) {
+        m_looseBVH.InsertObject(objects, objectIndex);
+    }
+}
+
+void PortalSystem::RemoveObject(const ObjectRemoval& removal) {
+    if (!m_built) return;
+
+    // Every tree relabels the moved object, whether or not it held the removed one
+    for (auto& cell : m_cells) {
+        cell.bvh->RemoveObject(removal);
+    }
+    m_looseBVH.RemoveObject(removal);
+
+    int slotCount = static_cast<int>(m_dynamicSlot.size());
+    if (removal.index >= slotCount) return;
+
+    int slot = m_dynamicSlot[removal.index];
+    if (slot >= 0) {
+        int last = m_dynamicObjects.back();
+        m_dynamicObjects[slot] = last;
+        m_dynamicSlot[last] = slot;
+        m_dynamicObjects.pop_back();
+        m_dynamicSlot[removal.index] = -1;
+    }
+    if (removal.movedFrom != removal.index && removal.movedFrom < slotCount) {
+        int movedSlot = m_dynamicSlot[removal.movedFrom];
+        if (movedSlot >= 0) {
+            m_dynamicObjects[movedSlot] = removal.index;
+        }
+        m_dynamicSlot[removal.index] = movedSlot;
+    }
+    if (removal.movedFrom < slotCount) {
+        m_dynamicSlot.resize(removal.movedFrom);
+    }
+}
+
+void PortalSystem::RemapObjects(const ObjectReorder& reorder) {
+    if (!m_built) return;
+
+    for (auto& cell : m_cells) {
+        cell.bvh->RemapObjects(reorder);
+    }
+    m_looseBVH.RemapObjects(reorder);
+
+    m_dynamicSlot.assign(reorder.newIndex.size(), -1);
+    for (size_t slot = 0; slot < m_dynamicObjects.size(); slot++) {
+        int objectIndex = reorder.newIndex[m_dynamicObjects[slot]];
+        m_dynamicObjects[slot] = objectIndex;
+        m_dynamicSlot[objectIndex] = static_cast<int>(slot);
+    }
+}
+
+void PortalSystem::AddDynamicObject(int objectIndex) {
+    if (static_cast<int>(m_dynamicSlot.size()) <= objectIndex) {
+        m_dynamicSlot.resize(objectIndex + 1, -1);
+    }
+    if (m_dynamicSlot[objectIndex] >= 0) return;
+    m_dynamicSlot[objectIndex] = static_cast<int>(m_dynamicObjects.size());
+    m_dynamicObjects.push_back(objectIndex);
+}
+
+int PortalSystem::FindCell(const Vector3& position) const {
+    for (size_t i = 0; i < m_cells.size(); ++i) {
+        const Cell& cell = m_cells[i];
+        if (position.x >= cell.minBounds.x && position.x <= cell.maxBounds.x &&
+            position.y >= cell.minBounds.y && position.y <= cell.maxBounds.y &&
+            position.z >= cell.minBounds.z && position.z <= cell.maxBounds.z) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+void PortalSystem::SetScreenSizeCulling(const ScreenSizeCullParams& params) {
+    for (auto& cell : m_cells) {
+        if (cell.bvh) {
+            cell.bvh->SetScreenSizeCulling(params);
+        }
+    }
+    m_looseBVH.SetScreenSizeCulling(params);
+}
+
+bool PortalSystem::PerformCulling(const Matrix& viewProjection, const Vector3& cameraPosition,
+                                  ObjectStore& objects) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+    m_stats.Reset();
+
+    int cameraCell = IsValid() ? FindCell(cameraPosition) : -1;
+    m_stats.cameraCell = cameraCell;
+    if (cameraCell < 0) return false;
+
+    m_viewProjection = viewProjection;
+    m_cameraPosition = cameraPosition;
+    objects.visible.ResetAll();
+
+    ScreenRect fullScreen = { -1.0f, -1.0f, 1.0f, 1.0f };
+    VisitCell(cameraCell, fullScreen, 0, objects);
+
+    // Nothing outside the cells is known to be behind a wall
+    Frustum cameraFrustum = MakeFrustum(fullScreen);
+    m_looseBVH.AccumulateFrustumCulling(cameraFrustum, objects);
+    m_stats.nodesVisited += m_looseBVH.GetStats().nodesVisited;
+    for (int index : m_dynamicObjects) {
+        const ObjectBounds& bounds = objects.bounds[index];
+        objects.visible.Set(index, cameraFrustum.IsBoxInFrustum(bounds.minBounds, bounds.maxBounds));
+    }
+
+    m_stats.cullTimeMs = std::chrono::duration<float, std::milli>(
+        std::chrono::high_resolution_clock::now() - startTime).count();
+    return true;
+}
+
+void PortalSystem::VisitCell(int cellIndex, const ScreenRect& rect, int depth, ObjectStore& objects) {
+    Cell& cell = m_cells[cellIndex];
+    m_cellsOnPath[cellIndex] = 1;
+    m_stats.cellsVisited++;
+    m_stats.maxDepth = std::max(m_stats.maxDepth, depth);
+
+    // Same plane representation as the camera frustum, only squeezed to the rectangle
+    Frustum frustum = MakeFrustum(rect);
+    cell.bvh->AccumulateFrustumCulling(frustum, objects);
+    m_stats.nodesVisited += cell.bvh->GetStats().nodesVisited;
+
+    if (depth < Config::PORTAL_MAX_DEPTH) {
+        for (int portalIndex : cell.portals) {
+            const Portal& portal = m_portals[portalIndex];
+            int nextCell = portal.cells[0] == cellIndex ? portal.cells[1] : portal.cells[0];
+            if (m_cellsOnPath[nextCell]) continue;
+
+            m_stats.portalsTested++;
+            ScreenRect portalRect;
+            if (!ProjectPortal(portal, portalRect)) continue;
+
+            // What the parent opening leaves of the portal
+            ScreenRect narrowed = {
+                std::max(rect.minX, portalRect.minX), std::max(rect.minY, portalRect.minY),
+                std::min(rect.maxX, portalRect.maxX), std::min(rect.maxY, portalRect.maxY)
+            };
+            if (narrowed.minX >= narrowed.maxX || narrowed.minY >= narrowed.maxY) continue;
+
+            m_stats.portalsPassed++;
+            VisitCell(nextCell, narrowed, depth + 1, objects);
+        }
+    }
+
+    m_cellsOnPath[cellIndex] = 0;
+}
+
+bool PortalSystem::ProjectPortal(const Portal& portal, ScreenRect& rect) const {
+    // Standing in the doorway the portal is seen edge-on, yet everything behind it is in view
+    Vector3 portalMin = portal.corners[0];
+    Vector3 portalMax = portal.corners[0];
+    for (int i = 1; i < 4; i++) {
+        portalMin = Vector3::Min(portalMin, portal.corners[i]);
+        portalMax = Vector3::Max(portalMax, portal.corners[i]);
+    }
+    Vector3 margin(Config::PORTAL_NEAR_DISTANCE, Config::PORTAL_NEAR_DISTANCE, Config::PORTAL_NEAR_DISTANCE);
+    if (BoxesOverlap(m_cameraPosition, m_cameraPosition, portalMin - margin, portalMax + margin)) {
+        rect = { -1.0f, -1.0f, 1.0f, 1.0f };
+        return true;
+    }
+
+    XMFLOAT4 clip[4];
+    for (int i = 0; i < 4; i++) {
+        Vector4 transformed = Vector4::Transform(Vector4(portal.corners[i].x, portal.corners[i].y,
+                                                         portal.corners[i].z, 1.0f), m_viewProjection);
+        clip[i] = XMFLOAT4(transformed.x, transformed.y, transformed.z, transformed.w);
+    }
+
+    // Clip the polygon to the part in front of the camera before dividing
+    XMFLOAT4 clipped[8];
+    int count = 0;
+    for (int i = 0; i < 4; i++) {
+        const XMFLOAT4& a = clip[i];
+        const XMFLOAT4& b = clip[(i + 1) % 4];
+        bool aInFront = a.w > kMinClipW;
+        bool bInFront = b.w > kMinClipW;
+        if (aInFront) {
+            clipped[count++] = a;
+        }
+        if (aInFront != bInFront) {
+            float t = (kMinClipW - a.w) / (b.w - a.w);
+            clipped[count++] = XMFLOAT4(a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t,
+                                        a.z + (b.z - a.z) * t, kMinClipW);
+        }
+    }
+    if (count < 3) return false;
+
+    float firstX = clipped[0].x / clipped[0].w;
+    float firstY = clipped[0].y / clipped[0].w;
+    rect = { firstX, firstY, firstX, firstY };
+    for (int i = 1; i < count; i++) {
+        float x = clipped[i].x / clipped[i].w;
+        float y = clipped[i].y / clipped[i].w;
+        rect.minX = std::min(rect.minX, x);
+        rect.minY = std::min(rect.minY, y);
+        rect.maxX = std::max(rect.maxX, x);
+        rect.maxY = std::max(rect.maxY, y);
+    }
+    return true;
+}
+
+Frustum PortalSystem::MakeFrustum(const ScreenRect& rect) const {
+    // Remaps the rectangle to the full NDC square after projection
+    float scaleX = 2.0f / (rect.maxX - rect.minX);
+    float scaleY = 2.0f / (rect.maxY - rect.minY);
+    Matrix remap = Matrix::Identity;
+    remap._11 = scaleX;
+    remap._41 = -(rect.minX + rect.maxX) / (rect.maxX - rect.minX);
+    remap._22 = scaleY;
+    remap._42 = -(rect.minY + rect.maxY) / (rect.maxY - rect.minY);
+
+    Frustum frustum;
+    frustum.ExtractFromMatrix(m_viewProjection * remap);
+    return frustum;
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "Common.h"
+#include "Structures.h"
+#include "ObjectStore.h"
+#include "CPUBVHSystem.h"
+
+// ============================================================================
+// PORTAL SYSTEM CLASS (cells and portals)
+// ============================================================================
+
+// Indoor visibility: the level is split into box-shaped cells (rooms) joined
+// by convex quad portals (doorways). Every cell has its own BVH over the static
+// objects overlapping it. Culling starts in the camera's cell with the camera
+// frustum and steps through each portal that is on screen, narrowing the view
+// to the portal's screen rectangle, so only cells seen through a chain of
+// openings are culled at all - and only against what the openings let through.
+class PortalSystem {
+public:
+    PortalSystem() = default;
+    ~PortalSystem() = default;
+
+    // Level authoring; Build must follow before culling
+    int AddCell(const Vector3& minBounds, const Vector3& maxBounds);
+    // Corners in order around the opening
+    int AddPortal(int cellA, int cellB, const Vector3 corners[4]);
+    void Clear();
+
+    // Static objects go into every cell they overlap; dynamic objects and
+    // objects outside all cells are culled with the camera frustum alone
+    void Build(const ObjectStore& objects);
+    // Objects spawned or despawned after Build, sorted the same way. Cells and
+    // portals are level layout: removing a wall does not open a new portal.
+    void InsertObject(const ObjectStore& objects, int objectIndex);
+    void RemoveObject(const ObjectRemoval& removal);
+    void RemapObjects(const ObjectReorder& reorder);
+    bool IsValid() const { return m_built && !m_cells.empty(); }
+
+    // -1 when the position is in no cell
+    int FindCell(const Vector3& position) const;
+
+    // Resets visibility and marks what the portal walk reaches. False when the
+    // camera is in no cell; objects are left untouched and the caller culls normally.
+    bool PerformCulling(const Matrix& viewProjection, const Vector3& cameraPosition, ObjectStore& objects);
+
+    void SetScreenSizeCulling(const ScreenSizeCullParams& params);
+    const PortalStats& GetStats() const { return m_stats; }
+    size_t GetCellCount() const { return m_cells.size(); }
+
+private:
+    struct Cell {
+        Vector3 minBounds;
+        Vector3 maxBounds;
+        std::vector<int> portals;
+        std::unique_ptr<CPUBVHSystem> bvh;
+    };
+
+    struct Portal {
+        Vector3 corners[4];
+        int cells[2];
+    };
+
+    // Region of the screen still open, in NDC
+    struct ScreenRect {
+        float minX, minY, maxX, maxY;
+    };
+
+    std::vector<Cell> m_cells;
+    std::vector<Portal> m_portals;
+    std::vector<int> m_dynamicObjects;
+    std::vector<int> m_dynamicSlot;      // Per object index, position in m_dynamicObjects or -1
+    CPUBVHSystem m_looseBVH;
+    bool m_built = false;
+
+    Matrix m_viewProjection;
+    Vector3 m_cameraPosition;
+    std::vector<uint8_t> m_cellsOnPath;  // Cells on the current portal chain, to break cycles
+    PortalStats m_stats;
+
+    void AddDynamicObject(int objectIndex);
+    void VisitCell(int cellIndex, const ScreenRect& rect, int depth, ObjectStore& objects);
+    bool ProjectPortal(const Portal& portal, ScreenRect& rect) const;
+    Frustum MakeFrustum(const ScreenRect& rect) const;
+};
@@ -0,0 +1,282 @@
+#include "PotentiallyVisibleSet.h"
+
+namespace {
+    constexpr uint32_t kFileMagic = 0x31535650;   // "PVS1"
+    constexpr uint32_t kFillFlag = 0x80000000u;
+    constexpr uint32_t kFillOnes = 0x40000000u;
+    constexpr uint32_t kMaxRun = 0x3FFFFFFFu;
+
+    uint32_t HashBytes(uint32_t hash, const void* data, size_t size) {
+        // FNV-1a
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        for (size_t i = 0; i < size; i++) {
+            hash ^= bytes[i];
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+}
+
+// ============================================================================
+// POTENTIALLY VISIBLE SET IMPLEMENTATION
+// ============================================================================
+
+void PotentiallyVisibleSet::Reset(const Vector3& minBounds, const Vector3& maxBounds, float cellSize,
+                                  size_t objectCount, uint32_t sceneSignature) {
+    Clear();
+
+    m_minBounds = minBounds;
+    m_cellSize = std::max(cellSize, 1e-3f);
+    Vector3 extent = maxBounds - minBounds;
+    m_cellsX = std::max(static_cast<int>(ceilf(extent.x / m_cellSize)), 1);
+    m_cellsY = std::max(static_cast<int>(ceilf(extent.y / m_cellSize)), 1);
+    m_cellsZ = std::max(static_cast<int>(ceilf(extent.z / m_cellSize)), 1);
+    m_cellCount = static_cast<size_t>(m_cellsX) * m_cellsY * m_cellsZ;
+    m_objectCount = objectCount;
+    m_sceneSignature = sceneSignature;
+
+    m_cellSets.reserve(m_cellCount);
+}
+
+void PotentiallyVisibleSet::AddCell(const std::vector<uint32_t>& visibleBits) {
+    CompressBits(visibleBits, m_compressScratch);
+    uint32_t hash = HashBytes(2166136261u, m_compressScratch.data(), m_compressScratch.size() * sizeof(uint32_t));
+
+    // Reuse an identical set when there is one
+    auto range = m_setLookup.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+        uint32_t begin = m_setOffsets[it->second];
+        uint32_t end = m_setOffsets[it->second + 1];
+        if (end - begin == m_compressScratch.size() &&
+            std::equal(m_compressScratch.begin(), m_compressScratch.end(), m_data.begin() + begin)) {
+            m_cellSets.push_back(it->second);
+            return;
+        }
+    }
+
+    uint32_t setIndex = static_cast<uint32_t>(m_setOffsets.size() - 1);
+    m_data.insert(m_data.end(), m_compressScratch.begin(), m_compressScratch.end());
+    m_setOffsets.push_back(static_cast<uint32_t>(m_data.size()));
+    m_setLookup.emplace(hash, setIndex);
+    m_cellSets.push_back(setIndex);
+}
+
+void PotentiallyVisibleSet::Clear() {
+    m_cellsX = m_cellsY = m_cellsZ = 0;
+    m_cellCount = 0;
+    m_objectCount = 0;
+    m_sceneSignature = 0;
+    m_cellSets.clear();
+    m_setOffsets.assign(1, 0u);
+    m_data.clear();
+    m_setLookup.clear();
+    m_objectHandles.clear();
+    m_bakedIndexBySlot.clear();
+}
+
+bool PotentiallyVisibleSet::BindObjects(const ObjectStore& objects) {
+    m_objectHandles.clear();
+    m_bakedIndexBySlot.clear();
+    if (!IsValid() || objects.Size() != m_objectCount) return false;
+
+    m_objectHandles.resize(m_objectCount);
+    for (size_t i = 0; i < m_objectCount; i++) {
+        ObjectHandle handle = objects.GetHandle(i);
+        m_objectHandles[i] = handle;
+        if (m_bakedIndexBySlot.size() <= handle.slot) {
+            m_bakedIndexBySlot.resize(handle.slot + 1, -1);
+        }
+        m_bakedIndexBySlot[handle.slot] = static_cast<int>(i);
+    }
+    return true;
+}
+
+bool PotentiallyVisibleSet::IsBakedObject(ObjectHandle handle) const {
+    if (handle.slot >= m_bakedIndexBySlot.size()) return false;
+    int bakedIndex = m_bakedIndexBySlot[handle.slot];
+    return bakedIndex >= 0 && m_objectHandles[bakedIndex] == handle;
+}
+
+int PotentiallyVisibleSet::FindCell(const Vector3& position) const {
+    if (!IsValid()) return -1;
+
+    Vector3 local = (position - m_minBounds) / m_cellSize;
+    int x = static_cast<int>(floorf(local.x));
+    int y = static_cast<int>(floorf(local.y));
+    int z = static_cast<int>(floorf(local.z));
+    if (x < 0 || y < 0 || z < 0 || x >= m_cellsX || y >= m_cellsY || z >= m_cellsZ) return -1;
+
+    return (z * m_cellsY + y) * m_cellsX + x;
+}
+
+bool PotentiallyVisibleSet::DecodeCell(int cell, const ObjectStore& objects,
+                                       VisibilitySet& mask) const {
+    bool bound = !m_objectHandles.empty();
+    if (!IsValid() || cell < 0 || cell >= static_cast<int>(m_cellCount) || (!bound && objects.Size() != m_objectCount)) {
+        return false;
+    }
+
+    uint32_t set = m_cellSets[cell];
+    uint32_t begin = m_setOffsets[set];
+    uint32_t end = m_setOffsets[set + 1];
+    if (!DecompressBits(m_data.data() + begin, end - begin, m_decodeWords, (m_objectCount + 31) / 32)) {
+        return false;
+    }
+
+    if (!bound) {
+        mask.Assign(m_objectCount, false);
+        for (size_t i = 0; i < m_objectCount; i++) {
+            bool baked = (m_decodeWords[i >> 5] >> (i & 31)) & 1u;
+            mask.Set(i, baked || objects.dynamic[i]);
+        }
+        return true;
+    }
+
+    // Baked objects are found through their handles wherever they live now
+    mask.Assign(objects.Size(), true);
+    for (size_t i = 0; i < m_objectCount; i++) {
+        int index = objects.IndexOf(m_objectHandles[i]);
+        if (index < 0) continue;
+        bool baked = (m_decodeWords[i >> 5] >> (i & 31)) & 1u;
+        mask.Set(index, baked || objects.dynamic[index]);
+    }
+    return true;
+}
+
+uint32_t PotentiallyVisibleSet::ComputeSceneSignature(const ObjectStore& objects) {
+    uint32_t hash = 2166136261u;
+    uint32_t count = static_cast<uint32_t>(objects.Size());
+    hash = HashBytes(hash, &count, sizeof(count));
+
+    // Dynamic objects move, only their slot is part of the scene
+    for (size_t i = 0; i < objects.Size(); ++i) {
+        uint8_t isDynamic = objects.dynamic[i] ? 1 : 0;
+        hash = HashBytes(hash, &isDynamic, sizeof(isDynamic));
+        if (isDynamic) continue;
+
+        const ObjectBounds& bounds = objects.bounds[i];
+        hash = HashBytes(hash, &bounds.minBounds, sizeof(bounds.minBounds));
+        hash = HashBytes(hash, &bounds.maxBounds, sizeof(bounds.maxBounds));
+        hash = HashBytes(hash, &objects.shapes[i].occluderHalfSize, sizeof(Vector3));
+    }
+    return hash;
+}
+
+bool PotentiallyVisibleSet::Matches(const ObjectStore& objects) const {
+    return IsValid() && objects.Size() == m_objectCount && ComputeSceneSignature(objects) == m_sceneSignature;
+}
+
+void PotentiallyVisibleSet::CompressBits(const std::vector<uint32_t>& words, std::vector<uint32_t>& out) {
+    out.clear();
+
+    // A fill between literals costs two tokens, so it only pays off from three equal words on
+    auto fillRun = [&words](size_t start) -> size_t {
+        uint32_t word = words[start];
+        if (word != 0u && word != 0xFFFFFFFFu) return 0;
+        size_t run = 1;
+        while (start + run < words.size() && words[start + run] == word && run < kMaxRun) run++;
+        return run >= 3 ? run : 0;
+    };
+
+    size_t i = 0;
+    while (i < words.size()) {
+        size_t run = fillRun(i);
+        if (run > 0) {
+            out.push_back(kFillFlag | (words[i] ? kFillOnes : 0u) | static_cast<uint32_t>(run));
+            i += run;
+            continue;
+        }
+
+        // Literals run until the next fill
+        size_t tokenIndex = out.size();
+        out.push_back(0u);
+        size_t literals = 0;
+        while (i < words.size() && literals < kMaxRun && (literals == 0 || fillRun(i) == 0)) {
+            out.push_back(words[i++]);
+            literals++;
+        }
+        out[tokenIndex] = static_cast<uint32_t>(literals);
+    }
+}
+
+bool PotentiallyVisibleSet::DecompressBits(const uint32_t* data, size_t size, std::vector<uint32_t>& words,
+                                           size_t wordCount) {
+    words.clear();
+    words.reserve(wordCount);
+
+    size_t i = 0;
+    while (i < size) {
+        uint32_t token = data[i++];
+        if (token & kFillFlag) {
+            uint32_t fill = (token & kFillOnes) ? 0xFFFFFFFFu : 0u;
+            words.insert(words.end(), token & kMaxRun, fill);
+        } else {
+            if (i + token > size) return false;
+            words.insert(words.end(), data + i, data + i + token);
+            i += token;
+        }
+    }
+    return words.size() == wordCount;
+}
+
+bool PotentiallyVisibleSet::SaveToFile(const char* path) const {
+    if (!IsValid()) return false;
+
+    FILE* file = nullptr;
+    if (fopen_s(&file, path, "wb") != 0 || !file) return false;
+
+    uint32_t header[8] = {
+        kFileMagic, m_sceneSignature, static_cast<uint32_t>(m_objectCount),
+        static_cast<uint32_t>(m_cellsX), static_cast<uint32_t>(m_cellsY), static_cast<uint32_t>(m_cellsZ),
+        static_cast<uint32_t>(m_setOffsets.size()), static_cast<uint32_t>(m_data.size())
+    };
+    float grid[4] = { m_minBounds.x, m_minBounds.y, m_minBounds.z, m_cellSize };
+
+    bool ok = fwrite(header, sizeof(header), 1, file) == 1 &&
+              fwrite(grid, sizeof(grid), 1, file) == 1 &&
+              fwrite(m_cellSets.data(), sizeof(uint32_t), m_cellSets.size(), file) == m_cellSets.size() &&
+              fwrite(m_setOffsets.data(), sizeof(uint32_t), m_setOffsets.size(), file) == m_setOffsets.size() &&
+              (m_data.empty() || fwrite(m_data.data(), sizeof(uint32_t), m_data.size(), file) == m_data.size());
+    fclose(file);
+    return ok;
+}
+
+bool PotentiallyVisibleSet::LoadFromFile(const char* path) {
+    Clear();
+
+    FILE* file = nullptr;
+    if (fopen_s(&file, path, "rb") != 0 || !file) return false;
+
+    uint32_t header[8] = {};
+    float grid[4] = {};
+    bool ok = fread(header, sizeof(header), 1, file) == 1 && header[0] == kFileMagic &&
+              fread(grid, sizeof(grid), 1, file) == 1;
+
+    if (ok) {
+        m_sceneSignature = header[1];
+        m_objectCount = header[2];
+        m_cellsX = static_cast<int>(header[3]);
+        m_cellsY = static_cast<int>(header[4]);
+        m_cellsZ = static_cast<int>(header[5]);
+        m_cellCount = static_cast<size_t>(m_cellsX) * m_cellsY * m_cellsZ;
+        m_minBounds = Vector3(grid[0], grid[1], grid[2]);
+        m_cellSize = grid[3];
+
+        m_cellSets.resize(m_cellCount);
+        m_setOffsets.resize(std::max<uint32_t>(header[6], 1u));
+        m_data.resize(header[7]);
+        ok = fread(m_cellSets.data(), sizeof(uint32_t), m_cellSets.size(), file) == m_cellSets.size() &&
+             fread(m_setOffsets.data(), sizeof(uint32_t), m_setOffsets.size(), file) == m_setOffsets.size() &&
+             (m_data.empty() || fread(m_data.data(), sizeof(uint32_t), m_data.size(), file) == m_data.size()) &&
+             m_setOffsets.back() == m_data.size();
+        for (size_t i = 0; ok && i < m_cellSets.size(); i++) {
+            ok = m_cellSets[i] + 1 < m_setOffsets.size();
+        }
+    }
+    fclose(file);
+
+    if (!ok) {
+        Clear();
+    }
+    return ok;
+}
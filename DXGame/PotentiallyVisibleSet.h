@@ -0,0 +1,80 @@
+#pragma once
+
+#include "Common.h"
+#include "Structures.h"
+#include "ObjectStore.h"
+#include <unordered_map>
+
+// ============================================================================
+// POTENTIALLY VISIBLE SET CLASS
+// ============================================================================
+
+// Baked visibility of static objects from a regular grid of cells. Each cell
+// stores the conservative set of static objects visible from anywhere inside
+// it as a word-aligned run-length compressed bitset: long runs of empty or full
+// words collapse into one token, so sparse sets cost little more than their
+// set bits. Neighbouring cells mostly see the same objects, so each distinct
+// set is stored once and cells index into the shared sets. Dynamic objects are
+// not baked and always pass the lookup, and so do objects spawned after the bake.
+class PotentiallyVisibleSet {
+public:
+    PotentiallyVisibleSet() = default;
+    ~PotentiallyVisibleSet() = default;
+
+    // Lays out an empty grid covering [minBounds, maxBounds]; cells are filled in order with AddCell
+    void Reset(const Vector3& minBounds, const Vector3& maxBounds, float cellSize, size_t objectCount,
+               uint32_t sceneSignature);
+    void AddCell(const std::vector<uint32_t>& visibleBits);
+    void Clear();
+
+    bool IsValid() const { return m_cellCount > 0 && m_cellSets.size() == m_cellCount; }
+    // -1 outside the baked volume
+    int FindCell(const Vector3& position) const;
+    // Ties the baked object indices to the store's handles, so lookups survive objects
+    // being spawned and despawned. The store must still match the bake.
+    bool BindObjects(const ObjectStore& objects);
+    // Whether the handle is a baked object; removing one leaves the bake stale
+    bool IsBakedObject(ObjectHandle handle) const;
+
+    // One bit per current object: set for dynamic, unbaked and visible static ones
+    bool DecodeCell(int cell, const ObjectStore& objects, VisibilitySet& mask) const;
+
+    // The scene must match the one that was baked - objects, bounds and static flags
+    static uint32_t ComputeSceneSignature(const ObjectStore& objects);
+    bool Matches(const ObjectStore& objects) const;
+
+    bool SaveToFile(const char* path) const;
+    bool LoadFromFile(const char* path);
+
+    // Compressed bitset encoding: a token word with bit 31 set is a fill of
+    // (token & 0x3FFFFFFF) words, all ones when bit 30 is set, all zeros otherwise;
+    // without bit 31 it announces that many literal words following it.
+    static void CompressBits(const std::vector<uint32_t>& words, std::vector<uint32_t>& out);
+    static bool DecompressBits(const uint32_t* data, size_t size, std::vector<uint32_t>& words, size_t wordCount);
+
+    size_t GetCellCount() const { return m_cellCount; }
+    int GetCellsX() const { return m_cellsX; }
+    int GetCellsY() const { return m_cellsY; }
+    int GetCellsZ() const { return m_cellsZ; }
+    size_t GetObjectCount() const { return m_objectCount; }
+    size_t GetDistinctSetCount() const { return m_setOffsets.empty() ? 0 : m_setOffsets.size() - 1; }
+    size_t GetCompressedBytes() const { return (m_data.size() + m_setOffsets.size() + m_cellSets.size()) * sizeof(uint32_t); }
+    size_t GetUncompressedBytes() const { return m_cellCount * ((m_objectCount + 31) / 32) * sizeof(uint32_t); }
+
+private:
+    Vector3 m_minBounds;
+    float m_cellSize = 1.0f;
+    int m_cellsX = 0, m_cellsY = 0, m_cellsZ = 0;
+    size_t m_cellCount = 0;
+    size_t m_objectCount = 0;
+    uint32_t m_sceneSignature = 0;
+
+    std::vector<uint32_t> m_cellSets;      // Set index per cell
+    std::vector<uint32_t> m_setOffsets;    // Start of each set in m_data, plus the end
+    std::vector<uint32_t> m_data;
+    std::unordered_multimap<uint32_t, uint32_t> m_setLookup;   // Content hash -> set, while cells are added
+    mutable std::vector<uint32_t> m_decodeWords;
+    std::vector<ObjectHandle> m_objectHandles;  // Per baked index, once bound
+    std::vector<int> m_bakedIndexBySlot;       // Handle slot -> baked index, -1 if not baked
+    std::vector<uint32_t> m_compressScratch;
+};
@@ -0,0 +1,329 @@
+#include "SoftwareOcclusionCuller.h"
+
+namespace {
+    // Box faces as corner quads, in the same order as the front-facing tests below
+    const int kBoxFaces[6][4] = {
+        { 0, 2, 6, 4 }, { 1, 3, 7, 5 },   // -x, +x
+        { 0, 1, 5, 4 }, { 2, 3, 7, 6 },   // -y, +y
+        { 0, 1, 3, 2 }, { 4, 5, 7, 6 }    // -z, +z
+    };
+
+    float Cross(const XMFLOAT3& o, const XMFLOAT3& a, const XMFLOAT3& b) {
+        return (a.x - o.x) * (b.y - o.y) - (a.y - o.y) * (b.x - o.x);
+    }
+
+    // Convex hull of the projected corners (monotone chain), at most 6 points for a box
+    int ComputeScreenHull(const XMFLOAT3 screen[8], XMFLOAT3 hull[8]) {
+        XMFLOAT3 sorted[8];
+        std::copy(screen, screen + 8, sorted);
+        std::sort(sorted, sorted + 8, [](const XMFLOAT3& a, const XMFLOAT3& b) {
+            return a.x < b.x || (a.x == b.x && a.y < b.y);
+        });
+
+        XMFLOAT3 chain[16];
+        int count = 0;
+        for (int i = 0; i < 8; i++) {
+            while (count >= 2 && Cross(chain[count - 2], chain[count - 1], sorted[i]) <= 0.0f) count--;
+            chain[count++] = sorted[i];
+        }
+        for (int i = 6, lower = count + 1; i >= 0; i--) {
+            while (count >= lower && Cross(chain[count - 2], chain[count - 1], sorted[i]) <= 0.0f) count--;
+            chain[count++] = sorted[i];
+        }
+
+        int hullCount = std::max(count - 1, 0);
+        std::copy(chain, chain + hullCount, hull);
+        return hullCount;
+    }
+}
+
+SoftwareOcclusionCuller::SoftwareOcclusionCuller(int width, int height)
+    : m_width((width + 3) & ~3), m_height(height) {
+    // Width is kept a multiple of 4 so every SIMD step stays inside its row
+    m_depth.assign(static_cast<size_t>(m_width) * m_height, 1.0f);
+    m_occluderIds.assign(m_depth.size(), NO_OCCLUDER);
+}
+
+void SoftwareOcclusionCuller::PerformOcclusionCulling(const Matrix& viewProjection, const Vector3& cameraPosition,
+                                                      ObjectStore& objects) {
+    RenderOccluders(viewProjection, cameraPosition, objects);
+    CullOccludedObjects(objects);
+}
+
+void SoftwareOcclusionCuller::RenderOccluders(const Matrix& viewProjection, const Vector3& cameraPosition,
+                                              const ObjectStore& objects, const Frustum* frustum,
+                                              const VisibilitySet* candidateMask) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+    BeginFrame(viewProjection, cameraPosition);
+
+    m_selector.SelectOccluders(objects, viewProjection, static_cast<float>(m_width), static_cast<float>(m_height),
+                               cameraPosition, frustum, candidateMask);
+
+    // The slot in the selection doubles as the occluder ID
+    const auto& selection = m_selector.GetSelection();
+    for (int slot = 0; slot < static_cast<int>(selection.size()); slot++) {
+        Vector3 occluderMin, occluderMax;
+        objects.GetOccluderBounds(selection[slot].objectIndex, occluderMin, occluderMax);
+        RasterizeOccluder(occluderMin, occluderMax, slot);
+    }
+    RecordOccluderCoverage();
+
+    m_stats.rasterTimeMs = std::chrono::duration<float, std::milli>(
+        std::chrono::high_resolution_clock::now() - startTime).count();
+}
+
+void SoftwareOcclusionCuller::RemoveObject(const ObjectRemoval& removal) {
+    m_selector.RemoveObject(removal);
+
+    if (static_cast<size_t>(removal.movedFrom) < m_previouslyVisible.Size()) {
+        m_previouslyVisible.Set(removal.index, m_previouslyVisible.Test(removal.movedFrom));
+        m_previouslyVisible.Resize(removal.movedFrom);
+    }
+}
+
+void SoftwareOcclusionCuller::RemapObjects(const ObjectReorder& reorder) {
+    m_selector.RemapObjects(reorder);
+
+    // History of another size is dropped on the next two-phase pass anyway
+    if (m_previouslyVisible.Size() == reorder.newIndex.size()) {
+        VisibilitySet previouslyVisible(m_previouslyVisible.Size());
+        m_previouslyVisible.ForEachSet([&](size_t i) { previouslyVisible.Set(reorder.newIndex[i]); });
+        std::swap(m_previouslyVisible, previouslyVisible);
+    }
+}
+
+void SoftwareOcclusionCuller::PerformTwoPhaseCulling(const Matrix& viewProjection, const Vector3& cameraPosition,
+                                                     ObjectStore& objects) {
+    // No history yet: everything in view counts as last frame's set (a single-phase pass).
+    // Objects spawned since last frame start out the same way.
+    if (m_previouslyVisible.Size() != objects.Size()) {
+        m_previouslyVisible.Resize(objects.Size(), true);
+    }
+
+    // Phase one: last frame's visible objects are the occluders
+    RenderOccluders(viewProjection, cameraPosition, objects, nullptr, &m_previouslyVisible);
+
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    // Objects out of view leave the history; what remains was drawn by phase one
+    m_previouslyVisible.And(objects.visible);
+    m_stats.reusedVisible = static_cast<int>(m_previouslyVisible.Count());
+
+    // Phase two: one test per object in view - it decides newcomers now and everyone's history
+    objects.visible.ForEachSet([&](size_t i) {
+        m_stats.objectsTested++;
+        int occluderId = NO_OCCLUDER;
+        const ObjectBounds& bounds = objects.bounds[i];
+        bool occluded = IsOccluded(bounds.minBounds, bounds.maxBounds, &occluderId);
+        if (!occluded) {
+            m_stats.newlyVisible += m_previouslyVisible.Test(i) ? 0 : 1;
+            m_previouslyVisible.Set(i);
+            return;
+        }
+
+        m_selector.RecordOccludedObject(occluderId);
+        if (m_previouslyVisible.Test(i)) {
+            // Already drawn by phase one; it leaves the set next frame
+            m_stats.noLongerVisible++;
+            m_previouslyVisible.Reset(i);
+        } else {
+            objects.visible.Reset(i);
+            m_stats.objectsOccluded++;
+        }
+    });
+
+    m_stats.testTimeMs = std::chrono::duration<float, std::milli>(
+        std::chrono::high_resolution_clock::now() - startTime).count();
+}
+
+void SoftwareOcclusionCuller::CullOccludedObjects(ObjectStore& objects) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    objects.visible.ForEachSet([&](size_t i) {
+        m_stats.objectsTested++;
+        int occluderId = NO_OCCLUDER;
+        const ObjectBounds& bounds = objects.bounds[i];
+        if (IsOccluded(bounds.minBounds, bounds.maxBounds, &occluderId)) {
+            objects.visible.Reset(i);
+            m_stats.objectsOccluded++;
+            m_selector.RecordOccludedObject(occluderId);
+        }
+    });
+
+    m_stats.testTimeMs = std::chrono::duration<float, std::milli>(
+        std::chrono::high_resolution_clock::now() - startTime).count();
+}
+
+void SoftwareOcclusionCuller::BeginFrame(const Matrix& viewProjection, const Vector3& cameraPosition) {
+    m_viewProjection = viewProjection;
+    m_cameraPosition = cameraPosition;
+    m_stats.Reset();
+    std::fill(m_depth.begin(), m_depth.end(), 1.0f);
+    std::fill(m_occluderIds.begin(), m_occluderIds.end(), NO_OCCLUDER);
+}
+
+void SoftwareOcclusionCuller::RecordOccluderCoverage() {
+    for (int32_t id : m_occluderIds) {
+        if (id != NO_OCCLUDER) {
+            m_selector.RecordPixelsOwned(id, 1);
+        }
+    }
+}
+
+bool SoftwareOcclusionCuller::RasterizeOccluder(const Vector3& minBounds, const Vector3& maxBounds, int occluderId) {
+    XMFLOAT3 screen[8];
+    if (!ScreenBounds::ProjectCorners(m_viewProjection, static_cast<float>(m_width), static_cast<float>(m_height),
+                                      minBounds, maxBounds, screen)) {
+        // Clipping is not worth it for an occluder, dropping one only loses occlusion
+        m_stats.occludersSkipped++;
+        return false;
+    }
+
+    // The box is rasterized as one convex silhouette. Along any ray the entry point
+    // of a convex solid is the farthest of its front-face planes, so the depth is the
+    // max of at most three screen-space planes - exact, with no internal edges.
+    const bool faceVisible[6] = {
+        m_cameraPosition.x < minBounds.x, m_cameraPosition.x > maxBounds.x,
+        m_cameraPosition.y < minBounds.y, m_cameraPosition.y > maxBounds.y,
+        m_cameraPosition.z < minBounds.z, m_cameraPosition.z > maxBounds.z
+    };
+
+    XMVECTOR planeA[3], planeB[3], planeC[3];
+    int planeCount = 0;
+    for (int face = 0; face < 6; face++) {
+        if (!faceVisible[face]) continue;
+
+        const XMFLOAT3& p0 = screen[kBoxFaces[face][0]];
+        const XMFLOAT3& p1 = screen[kBoxFaces[face][1]];
+        const XMFLOAT3& p2 = screen[kBoxFaces[face][2]];
+        float denominator = Cross(p0, p1, p2);
+
+        float a = 0.0f, b = 0.0f, c;
+        if (fabsf(denominator) > 1e-4f) {
+            a = ((p1.z - p0.z) * (p2.y - p0.y) - (p2.z - p0.z) * (p1.y - p0.y)) / denominator;
+            b = ((p1.x - p0.x) * (p2.z - p0.z) - (p2.x - p0.x) * (p1.z - p0.z)) / denominator;
+            // Farthest depth the plane reaches inside the pixel, sampled at its center
+            c = p0.z - a * p0.x - b * p0.y + 0.5f * (fabsf(a) + fabsf(b));
+        } else {
+            // Edge-on face: fall back to its farthest corner
+            c = std::max({ p0.z, p1.z, p2.z, screen[kBoxFaces[face][3]].z });
+        }
+
+        planeA[planeCount] = XMVectorReplicate(a);
+        planeB[planeCount] = XMVectorReplicate(b);
+        planeC[planeCount] = XMVectorReplicate(c);
+        planeCount++;
+    }
+
+    XMFLOAT3 hull[8];
+    int hullCount = ComputeScreenHull(screen, hull);
+    if (planeCount == 0 || hullCount < 3) {
+        return false; // Camera inside the box, or the box projects to a line
+    }
+
+    // Hull edges as E(x, y) = a * x + b * y + c, shrunk by half a pixel so only fully
+    // covered pixels pass - an occluder must never claim a partially covered pixel
+    float edgeA[8], edgeB[8], edgeC[8];
+    float minX = hull[0].x, maxX = hull[0].x, minY = hull[0].y, maxY = hull[0].y;
+    for (int i = 0; i < hullCount; i++) {
+        const XMFLOAT3& from = hull[i];
+        const XMFLOAT3& to = hull[(i + 1) % hullCount];
+        edgeA[i] = from.y - to.y;
+        edgeB[i] = to.x - from.x;
+        edgeC[i] = -(edgeA[i] * from.x + edgeB[i] * from.y) - 0.5f * (fabsf(edgeA[i]) + fabsf(edgeB[i]));
+
+        minX = std::min(minX, from.x);
+        maxX = std::max(maxX, from.x);
+        minY = std::min(minY, from.y);
+        maxY = std::max(maxY, from.y);
+    }
+
+    int x0 = std::max(static_cast<int>(floorf(minX)), 0);
+    int x1 = std::min(static_cast<int>(floorf(maxX)), m_width - 1);
+    int y0 = std::max(static_cast<int>(floorf(minY)), 0);
+    int y1 = std::min(static_cast<int>(floorf(maxY)), m_height - 1);
+    if (x0 > x1 || y0 > y1) {
+        return false;
+    }
+
+    XMVECTOR laneOffsets = XMVectorSet(0.5f, 1.5f, 2.5f, 3.5f); // Pixel centers
+    XMVECTOR ids = XMVectorReplicateInt(static_cast<uint32_t>(occluderId));
+    int alignedX0 = x0 & ~3;
+
+    for (int y = y0; y <= y1; y++) {
+        XMVECTOR py = XMVectorReplicate(y + 0.5f);
+        float* row = &m_depth[static_cast<size_t>(y) * m_width];
+        int32_t* idRow = &m_occluderIds[static_cast<size_t>(y) * m_width];
+
+        for (int x = alignedX0; x <= x1; x += 4) {
+            XMVECTOR px = XMVectorAdd(XMVectorReplicate(static_cast<float>(x)), laneOffsets);
+
+            XMVECTOR inside = XMVectorTrueInt();
+            for (int i = 0; i < hullCount; i++) {
+                XMVECTOR edge = XMVectorMultiplyAdd(XMVectorReplicate(edgeA[i]), px,
+                    XMVectorMultiplyAdd(XMVectorReplicate(edgeB[i]), py, XMVectorReplicate(edgeC[i])));
+                inside = XMVectorAndInt(inside, XMVectorGreaterOrEqual(edge, XMVectorZero()));
+            }
+            if (XMVector4EqualInt(inside, XMVectorFalseInt())) continue;
+
+            XMVECTOR depth = XMVectorMultiplyAdd(planeA[0], px, XMVectorMultiplyAdd(planeB[0], py, planeC[0]));
+            for (int p = 1; p < planeCount; p++) {
+                depth = XMVectorMax(depth, XMVectorMultiplyAdd(planeA[p], px, XMVectorMultiplyAdd(planeB[p], py, planeC[p])));
+            }
+
+            // Nearer lanes take both the depth and the occluder ID
+            XMVECTOR stored = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&row[x]));
+            XMVECTOR nearer = XMVectorAndInt(inside, XMVectorLess(depth, stored));
+            XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(&row[x]), XMVectorSelect(stored, depth, nearer));
+
+            XMVECTOR storedIds = XMLoadInt4(reinterpret_cast<const uint32_t*>(&idRow[x]));
+            XMStoreInt4(reinterpret_cast<uint32_t*>(&idRow[x]), XMVectorSelect(storedIds, ids, nearer));
+        }
+    }
+
+    m_stats.occludersRasterized++;
+    return true;
+}
+
+bool SoftwareOcclusionCuller::IsOccluded(const Vector3& minBounds, const Vector3& maxBounds, int* occluderId) const {
+    ScreenBounds bounds;
+    if (!bounds.FromBox(m_viewProjection, static_cast<float>(m_width), static_cast<float>(m_height), minBounds, maxBounds)) {
+        return false; // Touches the near plane, it covers the camera
+    }
+
+    // Every pixel the projected rectangle touches
+    int x0 = std::max(static_cast<int>(floorf(bounds.minX)), 0);
+    int x1 = std::min(static_cast<int>(floorf(bounds.maxX)), m_width - 1);
+    int y0 = std::max(static_cast<int>(floorf(bounds.minY)), 0);
+    int y1 = std::min(static_cast<int>(floorf(bounds.maxY)), m_height - 1);
+    if (x0 > x1 || y0 > y1) {
+        return false;
+    }
+
+    // Occluded only if every covered pixel holds something strictly nearer
+    XMVECTOR depth = XMVectorReplicate(bounds.nearestDepth);
+    XMVECTOR laneOffsets = XMVectorSet(0.0f, 1.0f, 2.0f, 3.0f);
+    XMVECTOR rectMinX = XMVectorReplicate(static_cast<float>(x0));
+    XMVECTOR rectMaxX = XMVectorReplicate(static_cast<float>(x1));
+    int alignedX0 = x0 & ~3;
+
+    for (int y = y0; y <= y1; y++) {
+        const float* row = &m_depth[static_cast<size_t>(y) * m_width];
+        for (int x = alignedX0; x <= x1; x += 4) {
+            XMVECTOR laneX = XMVectorAdd(XMVectorReplicate(static_cast<float>(x)), laneOffsets);
+            XMVECTOR inRect = XMVectorAndInt(XMVectorGreaterOrEqual(laneX, rectMinX), XMVectorLessOrEqual(laneX, rectMaxX));
+
+            XMVECTOR stored = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&row[x]));
+            XMVECTOR visible = XMVectorAndInt(XMVectorGreaterOrEqual(stored, depth), inRect);
+            if (!XMVector4EqualInt(visible, XMVectorFalseInt())) {
+                return false;
+            }
+        }
+    }
+
+    if (occluderId) {
+        *occluderId = m_occluderIds[static_cast<size_t>((y0 + y1) / 2) * m_width + (x0 + x1) / 2];
+    }
+    return true;
+}
+
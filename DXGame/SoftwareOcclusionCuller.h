@@ -0,0 +1,83 @@
+#pragma once
+
+#include "Common.h"
+#include "Structures.h"
+#include "ObjectStore.h"
+#include "OccluderSelector.h"
+
+// ============================================================================
+// SOFTWARE OCCLUSION CULLER CLASS (CPU depth rasterizer)
+// ============================================================================
+
+enum class OcclusionMode {
+    None,
+    PerObject,      // Test each frustum-visible object after culling
+    TwoPhase,       // Last frame's visible set occludes, everything else is tested against it
+    HiZTraversal    // Test BVH nodes against a HiZ pyramid during traversal (CPU BVH only)
+};
+
+// Rasterizes occluder boxes into a low-resolution depth buffer, four pixels
+// per SIMD step, then rejects frustum-visible objects whose projected AABB
+// lies entirely behind it. Results are available in the same frame.
+// Occluders only write pixels they fully cover, at the farthest depth
+// inside the pixel, so the buffer never hides anything that is visible.
+// A parallel ID buffer records which occluder won each pixel, so every
+// occluder's contribution can be reported back to the OccluderSelector.
+class SoftwareOcclusionCuller {
+public:
+    SoftwareOcclusionCuller(int width = Config::SW_OCCLUSION_WIDTH, int height = Config::SW_OCCLUSION_HEIGHT);
+    ~SoftwareOcclusionCuller() = default;
+
+    static constexpr int NO_OCCLUDER = -1;
+
+    // Full pass: clear, rasterize the selected visible occluders, hide occluded objects
+    void PerformOcclusionCulling(const Matrix& viewProjection, const Vector3& cameraPosition,
+                                 ObjectStore& objects);
+
+    // Two-phase pass on the frustum-visible set. Phase one rasterizes last frame's visible
+    // objects and keeps them drawn; phase two tests everything else against that depth, and
+    // newly visible objects join this frame's draw. Every object's result seeds the next
+    // frame's set, so objects hidden since last frame drop out one frame later.
+    void PerformTwoPhaseCulling(const Matrix& viewProjection, const Vector3& cameraPosition,
+                                ObjectStore& objects);
+    void ResetVisibilityHistory() { m_previouslyVisible.Clear(); }
+    // Keeps the per-object history in step with the store's swap-remove
+    void RemoveObject(const ObjectRemoval& removal);
+    void RemapObjects(const ObjectReorder& reorder);
+
+    // Clears and rasterizes the occluders the selector picks. Candidates are the objects
+    // already marked visible, or - before culling has run - those passing the given frustum,
+    // optionally restricted by candidateMask.
+    void RenderOccluders(const Matrix& viewProjection, const Vector3& cameraPosition,
+                         const ObjectStore& objects, const Frustum* frustum = nullptr,
+                         const VisibilitySet* candidateMask = nullptr);
+    void CullOccludedObjects(ObjectStore& objects);
+
+    // Individual steps, for callers that pick their own occluders
+    void BeginFrame(const Matrix& viewProjection, const Vector3& cameraPosition);
+    bool RasterizeOccluder(const Vector3& minBounds, const Vector3& maxBounds, int occluderId = NO_OCCLUDER);
+    // occluderId receives the occluder owning the footprint's center pixel when occluded
+    bool IsOccluded(const Vector3& minBounds, const Vector3& maxBounds, int* occluderId = nullptr) const;
+    
+    OccluderSelector& GetOccluderSelector() { return m_selector; }
+    const OccluderSelector& GetOccluderSelector() const { return m_selector; }
+
+    // Depth buffer access (NDC depth, 1.0 = empty)
+    const std::vector<float>& GetDepthBuffer() const { return m_depth; }
+    int GetWidth() const { return m_width; }
+    int GetHeight() const { return m_height; }
+    const OcclusionStats& GetStats() const { return m_stats; }
+
+private:
+    int m_width;
+    int m_height;
+    std::vector<float> m_depth;
+    std::vector<int32_t> m_occluderIds;
+    Matrix m_viewProjection;
+    Vector3 m_cameraPosition;
+    OcclusionStats m_stats;
+    OccluderSelector m_selector;
+    VisibilitySet m_previouslyVisible;          // Two-phase history, per object index
+    
+    void RecordOccluderCoverage();
+};
@@ -54,11 +54,37 @@ void Frustum::ExtractFromMatrix(const Matrix& viewProjection) {
             planes[i].w /= length;
         }
     }
+    
+    // Corners come from unprojecting the NDC cube (D3D depth range 0..1)
+    Matrix inverseViewProjection = viewProjection.Invert();
+    for (int i = 0; i < 8; i++) {
+        Vector3 ndc((i & 1) ? 1.0f : -1.0f, (i & 2) ? 1.0f : -1.0f, (i & 4) ? 1.0f : 0.0f);
+        corners[i] = Vector3::Transform(ndc, inverseViewProjection);
+    }
+    
+    // Near and far rectangles are parallel, so only the side edges add new directions
+    edgeDirections[0] = corners[1] - corners[0];
+    edgeDirections[1] = corners[2] - corners[0];
+    for (int i = 0; i < 4; i++) {
+        edgeDirections[2 + i] = corners[4 + i] - corners[i];
+    }
+    
+    boundingCenter = Vector3::Zero;
+    for (int i = 0; i < 8; i++) {
+        boundingCenter += corners[i];
+    }
+    boundingCenter *= 0.125f;
+    boundingRadius = 0.0f;
+    for (int i = 0; i < 8; i++) {
+        boundingRadius = std::max(boundingRadius, (corners[i] - boundingCenter).Length());
+    }
 }
 
-bool Frustum::IsBoxInFrustum(const Vector3& minBounds, const Vector3& maxBounds) const {
+bool Frustum::IsBoxInFrustum(const Vector3& minBounds, const Vector3& maxBounds, uint32_t planeMask) const {
     // For each frustum plane, test if the AABB is completely outside
     for (int i = 0; i < 6; i++) {
+        if (!(planeMask & (1u << i))) continue;
+        
         // Find the "positive vertex" - the corner of the AABB that's furthest 
         // in the direction of the plane normal
         Vector3 positiveVertex;
@@ -78,3 +104,194 @@ bool Frustum::IsBoxInFrustum(const Vector3& minBounds, const Vector3& maxBounds)
     }
     return true; // AABB is inside or intersects the frustum
 }
+
+bool Frustum::IsOrientedBoxInFrustum(const Vector3& center, const Vector3 axes[3]) const {
+    for (int i = 0; i < 6; i++) {
+        Vector3 normal(planes[i].x, planes[i].y, planes[i].z);
+        float distance = normal.Dot(center) + planes[i].w;
+        float radius = fabsf(normal.Dot(axes[0])) + fabsf(normal.Dot(axes[1])) + fabsf(normal.Dot(axes[2]));
+        if (distance + radius < 0.0f) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ScreenSizeCullParams::IsTooSmall(const Vector3& minBounds, const Vector3& maxBounds) const {
+    Vector3 center = (minBounds + maxBounds) * 0.5f;
+    Vector3 extent = (maxBounds - minBounds) * 0.5f;
+    
+    // Nearest view depth of the box - a child box can never be nearer or larger,
+    // so rejecting a node never hides a child that would pass
+    float nearestDepth = (center - cameraPosition).Dot(cameraForward) -
+        (extent.x * fabsf(cameraForward.x) + extent.y * fabsf(cameraForward.y) + extent.z * fabsf(cameraForward.z));
+    if (nearestDepth <= nearPlane) {
+        return false; // Touches the near plane, may cover the whole screen
+    }
+    
+    float projectedDiameter = 2.0f * extent.Length() * pixelsPerUnit / nearestDepth;
+    return projectedDiameter < minPixelSize;
+}
+
+bool ScreenBounds::ProjectCorners(const Matrix& viewProjection, float width, float height,
+                                  const Vector3& minBounds, const Vector3& maxBounds, XMFLOAT3 screen[8]) {
+    XMMATRIX transform = viewProjection;
+    float halfWidth = width * 0.5f;
+    float halfHeight = height * 0.5f;
+    
+    for (int i = 0; i < 8; i++) {
+        XMVECTOR corner = XMVectorSet(
+            (i & 1) ? maxBounds.x : minBounds.x,
+            (i & 2) ? maxBounds.y : minBounds.y,
+            (i & 4) ? maxBounds.z : minBounds.z,
+            1.0f);
+        XMFLOAT4 clip;
+        XMStoreFloat4(&clip, XMVector3Transform(corner, transform));
+        
+        // D3D clip space: z < 0 is in front of the near plane
+        if (clip.z < 0.0f || clip.w <= 0.0f) {
+            return false;
+        }
+        
+        float invW = 1.0f / clip.w;
+        screen[i].x = (clip.x * invW + 1.0f) * halfWidth;
+        screen[i].y = (1.0f - clip.y * invW) * halfHeight;
+        screen[i].z = clip.z * invW;
+    }
+    
+    return true;
+}
+
+bool ScreenBounds::FromBox(const Matrix& viewProjection, float width, float height,
+                           const Vector3& minBounds, const Vector3& maxBounds) {
+    XMFLOAT3 screen[8];
+    if (!ProjectCorners(viewProjection, width, height, minBounds, maxBounds, screen)) {
+        return false;
+    }
+    
+    minX = maxX = screen[0].x;
+    minY = maxY = screen[0].y;
+    nearestDepth = screen[0].z;
+    for (int i = 1; i < 8; i++) {
+        minX = std::min(minX, screen[i].x);
+        maxX = std::max(maxX, screen[i].x);
+        minY = std::min(minY, screen[i].y);
+        maxY = std::max(maxY, screen[i].y);
+        nearestDepth = std::min(nearestDepth, screen[i].z);
+    }
+    return true;
+}
+
+bool Frustum::IsBoxInFrustumExact(const Vector3& minBounds, const Vector3& maxBounds) const {
+    return IsBoxInFrustum(minBounds, maxBounds) && !HasSeparatingAxis(minBounds, maxBounds);
+}
+
+bool Frustum::HasSeparatingAxis(const Vector3& minBounds, const Vector3& maxBounds) const {
+    Vector3 center = (minBounds + maxBounds) * 0.5f;
+    Vector3 extent = (maxBounds - minBounds) * 0.5f;
+    
+    // Projects both shapes onto the axis and checks for a gap between the intervals
+    auto separatedOn = [&](const Vector3& axis) {
+        if (axis.LengthSquared() < 1e-12f) return false; // Parallel edges give no axis
+        
+        float boxCenter = center.Dot(axis);
+        float boxRadius = extent.x * fabsf(axis.x) + extent.y * fabsf(axis.y) + extent.z * fabsf(axis.z);
+        
+        float frustumMin = corners[0].Dot(axis);
+        float frustumMax = frustumMin;
+        for (int i = 1; i < 8; i++) {
+            float d = corners[i].Dot(axis);
+            frustumMin = std::min(frustumMin, d);
+            frustumMax = std::max(frustumMax, d);
+        }
+        
+        return boxCenter + boxRadius < frustumMin || boxCenter - boxRadius > frustumMax;
+    };
+    
+    // Box face normals - catches boxes beside a frustum corner
+    if (separatedOn(Vector3::UnitX) || separatedOn(Vector3::UnitY) || separatedOn(Vector3::UnitZ)) {
+        return true;
+    }
+    
+    // Frustum edges x box axes, written out for the unit axes
+    for (int i = 0; i < 6; i++) {
+        const Vector3& e = edgeDirections[i];
+        if (separatedOn(Vector3(0.0f, -e.z, e.y)) ||
+            separatedOn(Vector3(e.z, 0.0f, -e.x)) ||
+            separatedOn(Vector3(-e.y, e.x, 0.0f))) {
+            return true;
+        }
+    }
+    
+    return false;
+}
+
+CullResult Frustum::TestSphere(const Vector3& center, float radius, uint32_t* straddleMask) const {
+    // One dot product per plane - no positive vertex selection needed
+    uint32_t straddling = 0;
+    for (int i = 0; i < 6; i++) {
+        float distance = planes[i].x * center.x + 
+                       planes[i].y * center.y + 
+                       planes[i].z * center.z + 
+                       planes[i].w;
+        
+        if (distance < -radius) {
+            return CullResult::Outside;
+        }
+        if (distance < radius) {
+            straddling |= (1u << i);
+        }
+    }
+    
+    if (straddleMask) {
+        *straddleMask = straddling;
+    }
+    return straddling ? CullResult::Intersecting : CullResult::Inside;
+}
+
+void PackedFrustum::Pack(const Frustum& frustum) {
+    // Padding planes (0, 0, 0, 1) give distance 1 for every point, so they never reject
+    XMFLOAT4 p[8];
+    for (int i = 0; i < 6; i++) {
+        p[i] = frustum.planes[i];
+    }
+    p[6] = XMFLOAT4(0.0f, 0.0f, 0.0f, 1.0f);
+    p[7] = XMFLOAT4(0.0f, 0.0f, 0.0f, 1.0f);
+    
+    for (int i = 0; i < 2; i++) {
+        const XMFLOAT4* q = &p[i * 4];
+        planeX[i] = XMVectorSet(q[0].x, q[1].x, q[2].x, q[3].x);
+        planeY[i] = XMVectorSet(q[0].y, q[1].y, q[2].y, q[3].y);
+        planeZ[i] = XMVectorSet(q[0].z, q[1].z, q[2].z, q[3].z);
+        planeW[i] = XMVectorSet(q[0].w, q[1].w, q[2].w, q[3].w);
+        absPlaneX[i] = XMVectorAbs(planeX[i]);
+        absPlaneY[i] = XMVectorAbs(planeY[i]);
+        absPlaneZ[i] = XMVectorAbs(planeZ[i]);
+    }
+}
+
+bool PackedFrustum::IsBoxInFrustum(FXMVECTOR center, FXMVECTOR extent) const {
+    // Center/extent form of the positive vertex test: the box is outside a plane
+    // when dot(n, c) + w + dot(|n|, e) < 0
+    XMVECTOR cx = XMVectorSplatX(center);
+    XMVECTOR cy = XMVectorSplatY(center);
+    XMVECTOR cz = XMVectorSplatZ(center);
+    XMVECTOR ex = XMVectorSplatX(extent);
+    XMVECTOR ey = XMVectorSplatY(extent);
+    XMVECTOR ez = XMVectorSplatZ(extent);
+    
+    XMVECTOR outside = XMVectorFalseInt();
+    for (int i = 0; i < 2; i++) {
+        XMVECTOR distance = XMVectorMultiplyAdd(planeX[i], cx, planeW[i]);
+        distance = XMVectorMultiplyAdd(planeY[i], cy, distance);
+        distance = XMVectorMultiplyAdd(planeZ[i], cz, distance);
+        
+        XMVECTOR radius = XMVectorMultiply(absPlaneX[i], ex);
+        radius = XMVectorMultiplyAdd(absPlaneY[i], ey, radius);
+        radius = XMVectorMultiplyAdd(absPlaneZ[i], ez, radius);
+        
+        outside = XMVectorOrInt(outside, XMVectorLess(XMVectorAdd(distance, radius), XMVectorZero()));
+    }
+    
+    return XMVector4EqualInt(outside, XMVectorFalseInt());
+}
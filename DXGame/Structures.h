@@ -1,21 +1,41 @@
 #pragma once
 
 #include "Common.h"
+#include <cstddef>
 
 // ============================================================================
 // GPU-ALIGNED STRUCTURES
 // ============================================================================
 
-// GPU-aligned BVH Node for compute shaders
-struct GPUBVHNode {
-    float minBounds[4];      // Use float4 for alignment
-    float maxBounds[4];      // Use float4 for alignment  
-    int leftChild;
-    int rightChild;
-    int objectIndex;
-    int isLeaf;
+// BVH node shared by the CPU and GPU trees. The layout is the shaders' BVHNode
+// (float3 + int, float3 + int, float4, int4), one 64-byte line per node, so a
+// CPU-built tree is copied into the structured buffer as is and a GPU-built tree
+// read back is traversed by the CPU without converting a node.
+struct alignas(16) BVHNode {
+    Vector3 minBounds;
+    int leftChild = -1;
+    Vector3 maxBounds;
+    int rightChild = -1;
+    Vector3 sphereCenter;
+    float sphereRadius = -1.0f; // Optional bounding sphere, negative when absent
+    int objectIndex = -1;       // For leaf nodes
+    int isLeaf = 0;
+    int padding[2] = {};
+    
+    void ComputeSphereFromBounds() {
+        sphereCenter = (minBounds + maxBounds) * 0.5f;
+        sphereRadius = ((maxBounds - minBounds) * 0.5f).Length();
+    }
 };
 
+static_assert(sizeof(BVHNode) == 64, "BVHNode must match the shaders' 64-byte node stride");
+static_assert(offsetof(BVHNode, leftChild) == 12 && offsetof(BVHNode, maxBounds) == 16 &&
+              offsetof(BVHNode, rightChild) == 28 && offsetof(BVHNode, sphereCenter) == 32 &&
+              offsetof(BVHNode, sphereRadius) == 44 && offsetof(BVHNode, objectIndex) == 48 &&
+              offsetof(BVHNode, isLeaf) == 52, "BVHNode fields must sit where the shaders read them");
+
+using GPUBVHNode = BVHNode;
+
 // GPU-aligned Object data for compute shaders
 struct GPUObjectData {
     float minBounds[4];      // Use float4 for alignment
@@ -33,18 +53,14 @@ struct GPUMortonCode {
 };
 
 // GPU BVH construction data
-struct GPUBVHConstructionNode {
-    float minBounds[4];      // Use float4 for alignment
-    float maxBounds[4];      // Use float4 for alignment
-    int leftChild;
-    int rightChild;
-    int objectIndex;
-    int isLeaf;
-};
+using GPUBVHConstructionNode = BVHNode;
 
 // GPU Frustum data
 struct GPUFrustum {
     float planes[6][4]; // 6 planes, each with 4 components (x,y,z,w)
+    float cameraPosition[4];
+    float cameraForward[4];
+    float screenParams[4]; // pixelsPerUnit, minPixelSize, nearPlane, unused
 };
 
 // ============================================================================
@@ -73,56 +89,242 @@ struct BVHConstructionParams {
 // CPU STRUCTURES
 // ============================================================================
 
-// BVH Node Structure (CPU version)
-struct BVHNode {
-    Vector3 minBounds;
-    Vector3 maxBounds;
-    int leftChild = -1;
-    int rightChild = -1;
-    int objectIndex = -1; // For leaf nodes
-    bool isLeaf = false;
-};
-
-// Renderable Object
+// Description of a new object; ObjectStore::Add lays it out across its arrays
 struct RenderObject {
-    Matrix world;
-    Vector3 minBounds;
-    Vector3 maxBounds;
-    bool visible = true;
-    ComPtr<ID3D11Query> occlusionQuery;
-    UINT64 lastQueryResult = 0;
-    bool queryInProgress = false;
-    int occludedFrameCount = 0;  // Track consecutive occluded frames
-    
-    // Dynamic object support
+    Vector3 position = Vector3::Zero;
+    Vector3 scale = Vector3(1.0f, 1.0f, 1.0f);      // Of the drawn mesh
+    Quaternion rotation = Quaternion::Identity;
+    Vector3 localMin = Vector3(-0.5f, -0.5f, -0.5f);   // Mesh-space box of the drawn mesh, before scale
+    Vector3 localMax = Vector3(0.5f, 0.5f, 0.5f);
+    Vector3 occluderHalfSize = Vector3::Zero;      // Box inside the rendered mesh for software occlusion, zero if not an occluder
     bool isDynamic = false;
-    Vector3 velocity = Vector3::Zero;
-    Vector3 previousPosition = Vector3::Zero;
-    float movementDistance = 0.0f;
-    Vector3 baseSize = Vector3(1.0f, 1.0f, 1.0f);  // Object's base dimensions
     
     // Animation support
     float animationTime = 0.0f;
     Vector3 animationCenter = Vector3::Zero;
     float animationRadius = 0.0f;
+};
+
+// Result of a bounding volume vs frustum classification
+enum class CullResult {
+    Outside,
+    Intersecting,
+    Inside
+};
+
+// Projected-size culling parameters, derived from the camera projection and viewport
+struct ScreenSizeCullParams {
+    Vector3 cameraPosition;
+    Vector3 cameraForward;
+    float pixelsPerUnit = 0.0f;   // viewportHeight / (2 * tan(fov / 2)) - pixels per world unit at depth 1
+    float minPixelSize = 0.0f;    // Projected diameter threshold, 0 disables the test
+    float nearPlane = 0.1f;
     
-    // Helper methods
-    Vector3 GetPosition() const {
-        return Vector3(world._41, world._42, world._43);
-    }
+    bool IsEnabled() const { return minPixelSize > 0.0f && pixelsPerUnit > 0.0f; }
+    bool IsTooSmall(const Vector3& minBounds, const Vector3& maxBounds) const;
+};
+
+// Per-pass traversal counters, used to compare culling strategies in-engine
+struct CullingStats {
+    int nodesVisited = 0;
+    int nodesCulled = 0;
+    int sphereRejects = 0;      // Decided outside by the sphere test alone
+    int sphereAccepts = 0;      // Decided fully inside by the sphere test alone (whole subtree accepted)
+    int aabbFallbacks = 0;      // Sphere straddled a plane, AABB test was needed
+    int satTests = 0;           // Large nodes that ran the exact separating-axis test
+    int satRejects = 0;         // Plane-test false positives removed by the SAT test
+    int smallRejects = 0;       // Nodes/objects culled for projecting below the pixel threshold
+    int hizTests = 0;           // In-frustum nodes tested against the HiZ pyramid
+    int hizRejects = 0;         // Nodes (whole subtrees) hidden behind the occluders
+    int candidateRejects = 0;   // Subtrees without a potentially visible object
+    int orientedTests = 0;      // Rotated objects whose oriented box was tested after their world box passed
+    int orientedRejects = 0;    // World-box false positives removed by the oriented box
+    float cullTimeMs = 0.0f;
     
-    void UpdateBounds() {
-        Vector3 position = GetPosition();
-        Vector3 halfSize = baseSize * 0.5f;
-        minBounds = position - halfSize;
-        maxBounds = position + halfSize;
-    }
+    void Reset() { *this = CullingStats(); }
+};
+
+// Screen-space footprint of a projected box, used by the occlusion tests
+struct ScreenBounds {
+    float minX = 0.0f, minY = 0.0f;   // Pixels, y down
+    float maxX = 0.0f, maxY = 0.0f;
+    float nearestDepth = 0.0f;        // NDC depth of the nearest corner
+    
+    // Projects the 8 box corners (bit 0 = +x, bit 1 = +y, bit 2 = +z) to pixels and NDC depth.
+    // Returns false when the box crosses the near plane.
+    static bool ProjectCorners(const Matrix& viewProjection, float width, float height,
+                               const Vector3& minBounds, const Vector3& maxBounds, XMFLOAT3 screen[8]);
+    bool FromBox(const Matrix& viewProjection, float width, float height,
+                 const Vector3& minBounds, const Vector3& maxBounds);
+};
+
+// Per-frame software occlusion counters
+struct OcclusionStats {
+    int occludersRasterized = 0;
+    int occludersSkipped = 0;   // Crossed the near plane
+    int objectsTested = 0;
+    int objectsOccluded = 0;
+    int reusedVisible = 0;      // Two-phase: drawn from last frame's set
+    int newlyVisible = 0;       // Two-phase: passed phase two, drawn this frame
+    int noLongerVisible = 0;    // Two-phase: last frame's objects now hidden, dropped next frame
+    float rasterTimeMs = 0.0f;
+    float testTimeMs = 0.0f;
+    
+    void Reset() { *this = OcclusionStats(); }
+};
+
+// Per-frame portal culling counters
+struct PortalStats {
+    int cameraCell = -1;            // -1 when outside every cell and culling fell back to the full frustum
+    int cellsVisited = 0;           // A cell seen through two portal chains counts twice
+    int portalsTested = 0;
+    int portalsPassed = 0;          // On screen inside the parent opening
+    int maxDepth = 0;
+    int nodesVisited = 0;
+    float cullTimeMs = 0.0f;
+    
+    void Reset() { *this = PortalStats(); }
+};
+
+// Per-frame visibility cache outcome
+struct VisibilityCacheStats {
+    bool reused = false;            // Last frame's final visibility kept outright
+    bool refined = false;           // Last full pass's frustum results kept, boundary re-tested
+    int boundaryObjects = 0;        // In the band at the last full pass
+    int objectsRetested = 0;        // Band plus dynamic objects that moved since
+    float drift = 0.0f;             // Plane movement since the last full pass, world units
+    float timeMs = 0.0f;
+    
+    void Reset() { *this = VisibilityCacheStats(); }
+};
+
+// Linear culling with 16-bit bounds against full floats, since the last stats line
+struct QuantizedBoundsStats {
+    int culls = 0;
+    int64_t boundsBytes = 0;        // Bounds the culling kernel streamed
+    int64_t floatBoundsBytes = 0;   // The same culls with float bounds
+    int blocksEncoded = 0;          // Blocks re-quantized after layout changes or movement
+    int objectsSampled = 0;         // Culled both ways on sampled frames
+    int falsePositives = 0;         // Of those, kept by the quantized bounds but culled by the float bounds
+    
+    void Reset() { *this = QuantizedBoundsStats(); }
+};
+
+// Per-frame memory since the last stats line
+struct FrameMemoryStats {
+    int frames = 0;
+    int heapAllocations = 0;            // General-heap allocations (debug builds only)
+    int steadyFramesAllocating = 0;     // Steady-state frames that still allocated
+    
+    void Reset() { *this = FrameMemoryStats(); }
+};
+
+// Object storage reorders since the last stats line
+struct ObjectReorderStats {
+    int reorders = 0;
+    int objectsMoved = 0;           // Objects that changed index
+    int fromLeafOrder = 0;          // Reorders that followed the CPU BVH; the rest used Morton order
+    float timeMs = 0.0f;            // Order, store permutation and every system's relabeling
+    
+    void Reset() { *this = ObjectReorderStats(); }
+};
+
+// Runtime spawns and despawns since the last stats line
+struct ObjectLifetimeStats {
+    int spawned = 0;
+    int despawned = 0;
+    float timeMs = 0.0f;            // Store and culling-structure upkeep
+    
+    void Reset() { *this = ObjectLifetimeStats(); }
+};
+
+// Offline PVS bake results
+struct PVSBakeStats {
+    int cells = 0;
+    int distinctSets = 0;           // Cells seeing the same objects share one stored set
+    int samplePoints = 0;
+    int facesRendered = 0;          // Six per sample point
+    int staticObjects = 0;
+    float averageVisible = 0.0f;    // Static objects per cell
+    int compressedBytes = 0;
+    int uncompressedBytes = 0;
+    float bakeTimeMs = 0.0f;
+    
+    void Reset() { *this = PVSBakeStats(); }
+};
+
+// Per-frame hierarchical occlusion query counters. Queries are issued during
+// the draw, so the issue counters are those of the previous frame.
+struct QuerySchedulerStats {
+    int nodesVisited = 0;
+    int invisibleNodes = 0;         // Subtrees skipped because their last query saw nothing
+    int queriesIssued = 0;
+    int multiQueries = 0;           // Queries covering several invisible nodes
+    int nodesQueried = 0;
+    int visibleQueriesSkipped = 0;  // Visible leaves trusted until their re-check frame
+    int resultsReceived = 0;
+    int multiQueryFailures = 0;     // Batches that saw samples, so every node in them is drawn
+    int nodesTurnedVisible = 0;
+    int nodesTurnedInvisible = 0;   // Including parents pulled up with their children
+    int objectsHidden = 0;
+    int pendingQueries = 0;
+    float scheduleTimeMs = 0.0f;
+    
+    void Reset() { *this = QuerySchedulerStats(); }
+};
+
+// Per-frame adaptive per-object query counters. They are reset when queries
+// are issued, so the log sees this frame's polling and the previous frame's issuing.
+struct QueryFrequencyStats {
+    int queriesIssued = 0;
+    int hiddenRetests = 0;          // Depth-only queries on objects hidden by their last result
+    int queriesDeferred = 0;        // Due but over the budget, tried again next frame
+    int queriesPolled = 0;          // GetData calls, at most one past the last ready result
+    int resultsReceived = 0;
+    int queriesInFlight = 0;        // Left in the ring after polling
+    int oldestQueryAge = 0;         // Frames since the oldest of those was issued
+    int queryPoolSize = 0;          // Query objects created so far
+    int objectsHidden = 0;
+    int objectsInView = 0;
+    float averageInterval = 0.0f;   // Over objects in view
+    bool intervalsReset = false;    // The camera moved or turned fast
+    int intervalsResetNearMovers = 0;   // Stable objects on screen near something that moved
+    float pollTimeMs = 0.0f;
+    
+    void Reset() { *this = QueryFrequencyStats(); }
 };
 
 // Frustum structure for culling (CPU version)
 struct Frustum {
     XMFLOAT4 planes[6]; // left, right, top, bottom, near, far
+    Vector3 corners[8]; // bit 0 = +x, bit 1 = +y, bit 2 = far
+    Vector3 edgeDirections[6]; // unique edge directions: near x, near y, four side edges
+    Vector3 boundingCenter;
+    float boundingRadius = 0.0f;
     
     void ExtractFromMatrix(const Matrix& viewProjection);
-    bool IsBoxInFrustum(const Vector3& minBounds, const Vector3& maxBounds) const;
+    bool IsBoxInFrustum(const Vector3& minBounds, const Vector3& maxBounds, uint32_t planeMask = 0x3F) const;
+    CullResult TestSphere(const Vector3& center, float radius, uint32_t* straddleMask = nullptr) const;
+    
+    // Exact frustum-AABB test: plane test plus the separating axes it misses
+    bool IsBoxInFrustumExact(const Vector3& minBounds, const Vector3& maxBounds) const;
+    // Box face normals and frustum edge x box axis crosses - the axes beyond the six planes
+    bool HasSeparatingAxis(const Vector3& minBounds, const Vector3& maxBounds) const;
+    // Plane test of an oriented box; axes are its local axes scaled by the half extents
+    bool IsOrientedBoxInFrustum(const Vector3& center, const Vector3 axes[3]) const;
+};
+
+// SIMD frustum for batched culling - planes transposed to SoA so one
+// instruction tests four planes. Lanes 6 and 7 are padding planes that never reject.
+struct alignas(16) PackedFrustum {
+    XMVECTOR planeX[2];
+    XMVECTOR planeY[2];
+    XMVECTOR planeZ[2];
+    XMVECTOR planeW[2];
+    XMVECTOR absPlaneX[2];   // |normal| components for the box projected radius
+    XMVECTOR absPlaneY[2];
+    XMVECTOR absPlaneZ[2];
+    
+    void Pack(const Frustum& frustum);
+    bool IsBoxInFrustum(FXMVECTOR center, FXMVECTOR extent) const;
 };
@@ -0,0 +1,166 @@
+#include "VisibilityCache.h"
+
+// ============================================================================
+// VISIBILITY CACHE IMPLEMENTATION
+// ============================================================================
+
+void VisibilityCache::Invalidate() {
+    m_frustumValid = false;
+    m_finalValid = false;
+}
+
+bool VisibilityCache::RestoreUnchanged(const Matrix& viewProjection, uint32_t sceneGeneration,
+                                       ObjectStore& objects) {
+    m_stats.Reset();
+    m_stats.boundaryObjects = static_cast<int>(m_retestList.size());
+
+    if (!m_finalValid || sceneGeneration != m_finalGeneration || m_finalVisible.Size() != objects.Size()) {
+        return false;
+    }
+    // Bitwise: any change at all in the view has to be culled
+    if (memcmp(&viewProjection, &m_finalViewProjection, sizeof(Matrix)) != 0) {
+        return false;
+    }
+    for (size_t i = 0; i < objects.Size(); i++) {
+        if (objects.HasMoved(i)) return false;
+    }
+
+    objects.visible = m_finalVisible;
+    m_stats.reused = true;
+    return true;
+}
+
+bool VisibilityCache::RefineFrustumResults(const Frustum& frustum, uint32_t sceneGeneration, int pvsCell,
+                                           const VisibilitySet* pvsMask, const ScreenSizeCullParams& screenSize,
+                                           ObjectStore& objects) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    if (!m_frustumValid || !m_refinable || sceneGeneration != m_frustumGeneration || pvsCell != m_pvsCell ||
+        m_frustumVisible.Size() != objects.Size()) {
+        return false;
+    }
+
+    // Every object outside the band is at least the band width from each plane it was
+    // classified against, so it keeps its result until the planes move that far
+    m_stats.drift = MeasureDrift(frustum);
+    if (m_stats.drift >= Config::VISIBILITY_CACHE_BAND) {
+        return false;
+    }
+
+    // A dynamic object's classification is void once it moves
+    for (size_t i = 0; i < objects.Size(); i++) {
+        if (objects.HasMoved(i)) {
+            MarkRetest(i);
+        }
+    }
+
+    objects.visible = m_frustumVisible;
+
+    bool sizeCulling = screenSize.IsEnabled();
+    for (int index : m_retestList) {
+        const ObjectBounds& bounds = objects.bounds[index];
+        bool visible = frustum.IsBoxInFrustum(bounds.minBounds, bounds.maxBounds);
+        if (visible && sizeCulling && screenSize.IsTooSmall(bounds.minBounds, bounds.maxBounds)) {
+            visible = false;
+        }
+        if (visible && pvsMask && index < static_cast<int>(pvsMask->Size()) && !pvsMask->Test(index)) {
+            visible = false;
+        }
+        objects.visible.Set(index, visible);
+    }
+
+    m_stats.refined = true;
+    m_stats.objectsRetested = static_cast<int>(m_retestList.size());
+    m_stats.timeMs = std::chrono::duration<float, std::milli>(
+        std::chrono::high_resolution_clock::now() - startTime).count();
+    return true;
+}
+
+void VisibilityCache::StoreFrustumResults(const Frustum& frustum, const Vector3& sceneMin, const Vector3& sceneMax,
+                                          uint32_t sceneGeneration, int pvsCell, const ScreenSizeCullParams& screenSize,
+                                          bool refinable, const ObjectStore& objects) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    m_frustumValid = true;
+    m_refinable = refinable;
+    m_frustum = frustum;
+    m_sceneCenter = (sceneMin + sceneMax) * 0.5f;
+    m_sceneRadius = (sceneMax - sceneMin).Length() * 0.5f;
+    m_frustumGeneration = sceneGeneration;
+    m_pvsCell = pvsCell;
+
+    size_t count = objects.Size();
+    m_frustumVisible = objects.visible;
+    m_retest.assign(count, 0);
+    m_retestList.clear();
+    m_retestList.reserve(count);    // Each object is listed at most once
+    if (!refinable) {
+        m_stats.boundaryObjects = 0;
+        return;
+    }
+
+    // Objects near the pixel-size limit can flip without crossing a plane
+    ScreenSizeCullParams sizeBand = screenSize;
+    sizeBand.minPixelSize *= 2.0f;
+    bool sizeCulling = sizeBand.IsEnabled();
+
+    const float band = Config::VISIBILITY_CACHE_BAND;
+    for (size_t i = 0; i < count; i++) {
+        const ObjectBounds& bounds = objects.bounds[i];
+        Vector3 center = (bounds.minBounds + bounds.maxBounds) * 0.5f;
+        Vector3 extent = (bounds.maxBounds - bounds.minBounds) * 0.5f;
+
+        bool inside = true;
+        bool outside = false;
+        for (int p = 0; p < 6; p++) {
+            const XMFLOAT4& plane = frustum.planes[p];
+            float distance = plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w;
+            float radius = fabsf(plane.x) * extent.x + fabsf(plane.y) * extent.y + fabsf(plane.z) * extent.z;
+            if (distance + radius <= -band) {
+                outside = true;
+                break;
+            }
+            if (distance - radius < band) {
+                inside = false;
+            }
+        }
+
+        if (outside) continue;
+        if (!inside || (sizeCulling && sizeBand.IsTooSmall(bounds.minBounds, bounds.maxBounds))) {
+            MarkRetest(i);
+        }
+    }
+
+    m_stats.boundaryObjects = static_cast<int>(m_retestList.size());
+    m_stats.timeMs = std::chrono::duration<float, std::milli>(
+        std::chrono::high_resolution_clock::now() - startTime).count();
+}
+
+void VisibilityCache::StoreFinalResults(const Matrix& viewProjection, uint32_t sceneGeneration,
+                                        const ObjectStore& objects) {
+    m_finalValid = true;
+    m_finalViewProjection = viewProjection;
+    m_finalGeneration = sceneGeneration;
+
+    m_finalVisible = objects.visible;
+}
+
+float VisibilityCache::MeasureDrift(const Frustum& frustum) const {
+    // For p within the scene sphere: |dn.p + dw| <= |dn| * radius + |dn.center + dw|
+    float drift = 0.0f;
+    for (int p = 0; p < 6; p++) {
+        const XMFLOAT4& oldPlane = m_frustum.planes[p];
+        const XMFLOAT4& newPlane = frustum.planes[p];
+        Vector3 normalDelta(newPlane.x - oldPlane.x, newPlane.y - oldPlane.y, newPlane.z - oldPlane.z);
+        float offsetDelta = newPlane.w - oldPlane.w;
+        float planeDrift = normalDelta.Length() * m_sceneRadius + fabsf(normalDelta.Dot(m_sceneCenter) + offsetDelta);
+        drift = std::max(drift, planeDrift);
+    }
+    return drift;
+}
+
+void VisibilityCache::MarkRetest(size_t index) {
+    if (m_retest[index]) return;
+    m_retest[index] = 1;
+    m_retestList.push_back(static_cast<int>(index));
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "Common.h"
+#include "Structures.h"
+#include "ObjectStore.h"
+
+// ============================================================================
+// VISIBILITY CACHE CLASS
+// ============================================================================
+
+// Carries culling results over to the next frame. With the same view-projection,
+// the same scene generation and no dynamic object moving, last frame's final
+// visibility (frustum and occlusion) is reused outright. After a small camera
+// move, the frustum results of the last full pass are reused and only the
+// objects that were near a frustum plane - the boundary band, classified when
+// the results were stored - and the dynamic objects that moved since then are
+// re-tested. Occlusion always runs again after a refinement.
+class VisibilityCache {
+public:
+    VisibilityCache() = default;
+    ~VisibilityCache() = default;
+
+    // The next frame culls from scratch
+    void Invalidate();
+
+    // Restores the stored final visibility when nothing changed since it was stored
+    bool RestoreUnchanged(const Matrix& viewProjection, uint32_t sceneGeneration, ObjectStore& objects);
+
+    // Restores the stored frustum results and re-tests the boundary band and moved dynamic
+    // objects. False when the view drifted past the band or the settings differ; the caller
+    // then culls from scratch. pvsMask is the camera cell's set, or nullptr without one.
+    bool RefineFrustumResults(const Frustum& frustum, uint32_t sceneGeneration, int pvsCell,
+                              const VisibilitySet* pvsMask, const ScreenSizeCullParams& screenSize,
+                              ObjectStore& objects);
+
+    // After a full frustum pass. refinable is false when the results depend on more than
+    // the frustum planes (portal rectangles, HiZ tests), so later frames may only reuse
+    // them unchanged. sceneMin/Max bound every object that is not re-tested.
+    void StoreFrustumResults(const Frustum& frustum, const Vector3& sceneMin, const Vector3& sceneMax,
+                             uint32_t sceneGeneration, int pvsCell, const ScreenSizeCullParams& screenSize,
+                             bool refinable, const ObjectStore& objects);
+
+    // After occlusion, on full and refined frames alike
+    void StoreFinalResults(const Matrix& viewProjection, uint32_t sceneGeneration, const ObjectStore& objects);
+
+    const VisibilityCacheStats& GetStats() const { return m_stats; }
+
+private:
+    // Frustum pass the band was classified against
+    bool m_frustumValid = false;
+    bool m_refinable = false;
+    Frustum m_frustum;
+    Vector3 m_sceneCenter;
+    float m_sceneRadius = 0.0f;
+    uint32_t m_frustumGeneration = 0;
+    int m_pvsCell = -1;
+    VisibilitySet m_frustumVisible;
+    std::vector<uint8_t> m_retest;          // Boundary band, plus dynamic objects once they move
+    std::vector<int> m_retestList;
+
+    // Last frame's final results
+    bool m_finalValid = false;
+    Matrix m_finalViewProjection;
+    uint32_t m_finalGeneration = 0;
+    VisibilitySet m_finalVisible;
+
+    VisibilityCacheStats m_stats;
+
+    // Largest change of any plane's signed distance for points within the scene sphere
+    float MeasureDrift(const Frustum& frustum) const;
+    void MarkRetest(size_t index);
+};
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <intrin.h>
+#include <algorithm>
+#include <cstdint>
+#include "AlignedAllocator.h"
+
+// ============================================================================
+// VISIBILITY SET
+// ============================================================================
+
+// One bit per object index, packed into 64-bit words. Clearing, merging two
+// passes' results and comparing against last frame run a word at a time, and
+// set bits are walked without touching the clear ones. Bits past Size() in the
+// last word are always zero, so word-wise operations never count them.
+class VisibilitySet {
+public:
+    VisibilitySet() = default;
+    explicit VisibilitySet(size_t count, bool value = false) { Assign(count, value); }
+
+    size_t Size() const { return m_size; }
+    bool Empty() const { return m_size == 0; }
+    size_t WordCount() const { return m_words.size(); }
+    uint64_t* Words() { return m_words.data(); }
+    const uint64_t* Words() const { return m_words.data(); }
+
+    bool Test(size_t index) const { return (m_words[index >> 6] >> (index & 63)) & 1u; }
+    void Set(size_t index) { m_words[index >> 6] |= Bit(index); }
+    void Reset(size_t index) { m_words[index >> 6] &= ~Bit(index); }
+    void Set(size_t index, bool value) {
+        uint64_t& word = m_words[index >> 6];
+        word = (word & ~Bit(index)) | (static_cast<uint64_t>(value) << (index & 63));
+    }
+
+    // Every bit to value, with count bits
+    void Assign(size_t count, bool value) {
+        m_size = count;
+        m_words.assign(WordsFor(count), value ? ~0ull : 0ull);
+        TrimLastWord();
+    }
+    // New bits take value; existing ones keep theirs
+    void Resize(size_t count, bool value = false) {
+        size_t oldSize = m_size;
+        m_words.resize(WordsFor(count), value ? ~0ull : 0ull);
+        m_size = count;
+        if (value && count > oldSize && (oldSize & 63)) {
+            m_words[oldSize >> 6] |= ~0ull << (oldSize & 63);
+        }
+        TrimLastWord();
+    }
+    void Reserve(size_t count) { m_words.reserve(WordsFor(count)); }
+    void Clear() { m_size = 0; m_words.clear(); }
+
+    void SetAll() { std::fill(m_words.begin(), m_words.end(), ~0ull); TrimLastWord(); }
+    void ResetAll() { std::fill(m_words.begin(), m_words.end(), 0ull); }
+
+    // Appends a bit, as push_back would
+    void PushBack(bool value) {
+        if ((m_size & 63) == 0) {
+            m_words.push_back(0);
+        }
+        m_size++;
+        Set(m_size - 1, value);
+    }
+    // The last bit moves into index, as the object store's swap-remove does
+    void SwapRemove(size_t index) {
+        size_t last = m_size - 1;
+        Set(index, Test(last));
+        Reset(last);
+        m_size = last;
+        m_words.resize(WordsFor(m_size));
+    }
+
+    // Word-wise merges; other must have the same size
+    void And(const VisibilitySet& other) {
+        for (size_t w = 0; w < m_words.size(); w++) m_words[w] &= other.m_words[w];
+    }
+    void AndNot(const VisibilitySet& other) {
+        for (size_t w = 0; w < m_words.size(); w++) m_words[w] &= ~other.m_words[w];
+    }
+    void Or(const VisibilitySet& other) {
+        for (size_t w = 0; w < m_words.size(); w++) m_words[w] |= other.m_words[w];
+    }
+
+    size_t Count() const {
+        size_t count = 0;
+        for (uint64_t word : m_words) count += static_cast<size_t>(__popcnt64(word));
+        return count;
+    }
+    // Bits set here but not in other, e.g. objects that left the visible set since last frame
+    size_t CountAndNot(const VisibilitySet& other) const {
+        size_t count = 0;
+        for (size_t w = 0; w < m_words.size(); w++) count += static_cast<size_t>(__popcnt64(m_words[w] & ~other.m_words[w]));
+        return count;
+    }
+
+    // Calls f(index) for each set bit in ascending order; clear words cost one test.
+    // Each word is read once, so f may reset bits of this set, its own included.
+    template <typename F>
+    void ForEachSet(F f) const {
+        for (size_t w = 0; w < m_words.size(); w++) {
+            uint64_t word = m_words[w];
+            while (word) {
+                unsigned long bit;
+                _BitScanForward64(&bit, word);
+                f((w << 6) + bit);
+                word &= word - 1;
+            }
+        }
+    }
+
+    bool operator==(const VisibilitySet& other) const { return m_size == other.m_size && m_words == other.m_words; }
+    bool operator!=(const VisibilitySet& other) const { return !(*this == other); }
+
+private:
+    AlignedVector<uint64_t> m_words;
+    size_t m_size = 0;
+
+    static size_t WordsFor(size_t count) { return (count + 63) >> 6; }
+    static uint64_t Bit(size_t index) { return 1ull << (index & 63); }
+    void TrimLastWord() {
+        if (m_size & 63) {
+            m_words.back() &= ~0ull >> (64 - (m_size & 63));
+        }
+    }
+};